@@ -0,0 +1,306 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Offline decoding of a large capture on all cores. The capture is cut into chunks that overlap by one
+ * maximum-length frame; every chunk runs through its own channelizer and decoder on a pool of threads:
+ *
+ *     lora_offline --file capture.sigmf-meta --channel 868.1e6 --sf 7 [--threads 8] [--chunk 10]
+ *
+ * A frame belongs to the chunk in which its preamble was detected. Frames are merged by absolute sample
+ * offset. A frame whose preamble straddles a chunk boundary is detected again at the start of the next
+ * chunk; that copy, with the same SFD position and payload as a frame at the end of the previous chunk,
+ * is dropped. Each frame is
+ * printed as `offset time length payload`, with the offset in input samples and the time in seconds.
+ */
+
+#include <lora/channelizer.h>
+#include <lora/decoder.h>
+#include <lora/encoder.h>
+#include <lora/frame.h>
+#include <lora/logging.h>
+#include <lora/sigmf_source.h>
+#include <gnuradio/block.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/head.h>
+#include <boost/bind/bind.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <stdlib.h>
+
+#define OFFLINE_DEFAULT_CHUNK 10.0  ///< Seconds of signal per chunk.
+#define OFFLINE_MIN_CHUNKS    4u    ///< A chunk spans at least this many overlaps, so that overlaps stay cheap.
+
+namespace {
+
+    /**
+     *  \brief  Keeps the frames published by a decoder.
+     */
+    class frame_collector : public gr::block {
+        public:
+            typedef std::shared_ptr<frame_collector> sptr;
+
+            static sptr make() {
+                return gnuradio::get_initial_sptr(new frame_collector());
+            }
+
+            std::vector<gr::lora::frame_sptr> frames() {
+                std::lock_guard<std::mutex> lock(d_mutex);
+                return d_frames;
+            }
+
+        private:
+            std::mutex                        d_mutex;
+            std::vector<gr::lora::frame_sptr> d_frames;
+
+            frame_collector()
+                : gr::block("frame_collector", gr::io_signature::make(0, 0, 0), gr::io_signature::make(0, 0, 0)) {
+                message_port_register_in(pmt::mp("in"));
+                set_msg_handler(pmt::mp("in"), boost::bind(&frame_collector::handle, this, boost::placeholders::_1));
+            }
+
+            void handle(pmt::pmt_t msg) {
+                gr::lora::frame_sptr f = gr::lora::frame_from_pmt(msg);
+                if (!f)
+                    return;
+
+                std::lock_guard<std::mutex> lock(d_mutex);
+                d_frames.push_back(f);
+            }
+    };
+
+    typedef struct options {
+        std::string        file;
+        std::string        format;                  ///< Sample format of the file, if not in its metadata.
+        double             samp_rate     = 0.0;     ///< Defaults to the metadata, or 1e6.
+        double             center_freq   = 0.0;     ///< Defaults to the metadata, or 868e6.
+        double             channel       = 0.0;     ///< Defaults to the center frequency.
+        uint32_t           bandwidth     = 125000u;
+        uint32_t           sf            = 7u;
+        uint32_t           cr            = 4u;
+        bool               crc           = true;
+        bool               implicit      = false;
+        bool               reduced_rate  = false;
+        uint32_t           decimation    = 1u;
+        uint32_t           threads       = 0u;      ///< Defaults to the number of cores.
+        double             chunk         = OFFLINE_DEFAULT_CHUNK;
+        bool               verbose       = false;
+    } options_t;
+
+    typedef struct offline_frame {
+        uint64_t             offset;                ///< Input sample at which the preamble was detected.
+        uint64_t             sfd;                   ///< Input sample at which the SFD was found.
+        gr::lora::frame_sptr frame;
+    } offline_frame_t;
+
+    /**
+     *  Whether `f`, detected at the start of a chunk, is a frame that the previous chunk also decoded, as `previous`.
+     *  The two decoders may lock on different preamble upchirps, so the SFD is compared instead of the sync sample.
+     */
+    bool same_frame(const offline_frame_t& previous, const offline_frame_t& f, const uint64_t tolerance) {
+        const uint64_t distance = f.sfd > previous.sfd ? f.sfd - previous.sfd : previous.sfd - f.sfd;
+
+        return distance <= tolerance
+            && f.frame->payload_length() == previous.frame->payload_length()
+            && std::equal(f.frame->payload(), f.frame->payload() + f.frame->payload_length(), previous.frame->payload());
+    }
+
+    void usage(const char* name) {
+        std::cerr << "Usage: " << name << " --file capture [options]" << std::endl
+                  << "  --file path           SigMF recording or raw samples" << std::endl
+                  << "  --format f            Sample format of a raw file: cf32 (default), ci16 or ci8" << std::endl
+                  << "  --samp-rate hz        Sample rate of the input (metadata, or 1e6)" << std::endl
+                  << "  --center-freq hz      Center frequency of the input (metadata, or 868e6)" << std::endl
+                  << "  --channel hz          Channel to decode (center frequency)" << std::endl
+                  << "  --bandwidth hz        Channel bandwidth (125000)" << std::endl
+                  << "  --sf n --cr n         Spreading factor (7) and coding rate (4)" << std::endl
+                  << "  --no-crc --implicit --reduced-rate" << std::endl
+                  << "  --decimation n        Channelizer decimation (1)" << std::endl
+                  << "  --threads n           Chunks decoded at once (number of cores)" << std::endl
+                  << "  --chunk s             Seconds of signal per chunk (10)" << std::endl
+                  << "  --verbose             Also log frames as they are decoded" << std::endl;
+    }
+
+    bool parse(int argc, char** argv, options_t& o) {
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+            if (arg == "--no-crc")            { o.crc = false;          continue; }
+            if (arg == "--implicit")          { o.implicit = true;      continue; }
+            if (arg == "--reduced-rate")      { o.reduced_rate = true;  continue; }
+            if (arg == "--verbose")           { o.verbose = true;       continue; }
+            if (!value)
+                return false;
+
+            if      (arg == "--file")         o.file         = value;
+            else if (arg == "--format")       o.format       = value;
+            else if (arg == "--samp-rate")    o.samp_rate    = atof(value);
+            else if (arg == "--center-freq")  o.center_freq  = atof(value);
+            else if (arg == "--channel")      o.channel      = atof(value);
+            else if (arg == "--bandwidth")    o.bandwidth    = atoi(value);
+            else if (arg == "--sf")           o.sf           = atoi(value);
+            else if (arg == "--cr")           o.cr           = atoi(value);
+            else if (arg == "--decimation")   o.decimation   = atoi(value);
+            else if (arg == "--threads")      o.threads      = atoi(value);
+            else if (arg == "--chunk")        o.chunk        = atof(value);
+            else
+                return false;
+            i++;
+        }
+
+        return !o.file.empty() && o.decimation > 0u && o.chunk > 0.0;
+    }
+
+    /**
+     *  Decode `[start, end)` of the capture, reading `overlap` samples further, and return the frames
+     *  detected before `end`.
+     */
+    std::vector<offline_frame_t> decode_chunk(const options_t& o, uint64_t start, uint64_t end, uint64_t length, uint64_t overlap) {
+        gr::top_block_sptr tb = gr::make_top_block("lora_offline");
+        gr::lora::sigmf_source::sptr source = gr::lora::sigmf_source::make(o.file, o.format, false);
+        gr::block_sptr head = gr::blocks::head::make(sizeof(gr_complex), std::min(end + overlap, length) - start);
+        gr::lora::channelizer::sptr ch = gr::lora::channelizer::make(o.samp_rate, o.center_freq, std::vector<float>(1u, o.channel), o.bandwidth, o.decimation);
+        frame_collector::sptr collector = frame_collector::make();
+        gr::lora::decoder::sptr dec = gr::lora::decoder::make(o.samp_rate / o.decimation, o.bandwidth, o.sf, o.implicit, o.cr, o.crc, o.reduced_rate, false);
+
+        source->seek(start);
+        tb->connect(source, 0, head, 0);
+        tb->connect(head, 0, ch, 0);
+        tb->connect(ch, 0, dec, 0);
+        tb->msg_connect(dec, "frame_refs", collector, "in");
+        tb->run();
+
+        std::vector<offline_frame_t> result;
+        for (const gr::lora::frame_sptr& f : collector->frames()) {
+            const uint64_t offset = start + f->timing().detect_sample * o.decimation;
+            if (offset < end)
+                result.push_back({ offset, start + f->timing().sfd_sample * o.decimation, f });
+        }
+
+        return result;
+    }
+}
+
+int main(int argc, char** argv) {
+    options_t o;
+    if (!parse(argc, argv, o)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (!o.verbose)
+        gr::lora::set_log_level(gr::lora::log_category::FRAME, gr::lora::log_level::WARN);
+
+    uint64_t length;
+    uint64_t overlap;
+    uint64_t window;
+    uint64_t tolerance;
+    try {
+        gr::lora::sigmf_source::sptr capture = gr::lora::sigmf_source::make(o.file, o.format, false);
+        length = capture->length();
+
+        if (o.samp_rate <= 0.0)
+            o.samp_rate = capture->sample_rate() > 0.0 ? capture->sample_rate() : 1e6;
+        if (o.center_freq <= 0.0)
+            o.center_freq = capture->frequency() > 0.0 ? capture->frequency() : 868e6;
+        if (o.channel <= 0.0)
+            o.channel = o.center_freq;
+
+        // Symbol counts do not depend on the sample rate
+        const gr::lora::encoder enc(o.bandwidth, o.bandwidth, o.sf, o.cr, o.crc, o.implicit, o.reduced_rate);
+        const double samples_per_symbol = (double)(1u << o.sf) * o.samp_rate / o.bandwidth;
+        overlap = (uint64_t)((ENCODER_DEFAULT_PREAMBLE_LEN + 4.25 + enc.num_symbols(255u) + 2u) * samples_per_symbol);
+        window    = (uint64_t)((ENCODER_DEFAULT_PREAMBLE_LEN + 5u) * samples_per_symbol);
+        tolerance = (uint64_t)(samples_per_symbol / 2.0);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    const uint64_t chunk      = std::max((uint64_t)(o.chunk * o.samp_rate), OFFLINE_MIN_CHUNKS * overlap);
+    const uint64_t num_chunks = (length + chunk - 1u) / chunk;
+    const uint32_t threads    = std::max(o.threads ? o.threads : std::thread::hardware_concurrency(), 1u);
+
+    std::vector<std::vector<offline_frame_t>> chunk_frames(num_chunks);
+    std::atomic<uint64_t> next_chunk(0u);
+    std::vector<std::thread> pool;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (uint32_t t = 0u; t < std::min<uint64_t>(threads, num_chunks); t++) {
+        pool.emplace_back([&] {
+            for (uint64_t i = next_chunk++; i < num_chunks; i = next_chunk++)
+                chunk_frames[i] = decode_chunk(o, i * chunk, std::min((i + 1u) * chunk, length), length, overlap);
+        });
+    }
+    for (std::thread& t : pool)
+        t.join();
+
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Chunks are in order and each one only keeps frames detected before its end, so this is sorted
+    std::vector<offline_frame_t> frames;
+    uint64_t duplicates = 0u;
+    for (uint64_t i = 0u; i < num_chunks; i++) {
+        const uint64_t boundary = i * chunk;
+        const size_t   previous = frames.size();   // Frames of chunks before this one
+
+        for (const offline_frame_t& f : chunk_frames[i]) {
+            bool duplicate = false;
+
+            // Only a preamble detected right after the boundary can have started in the previous chunk
+            for (size_t j = previous; f.offset < boundary + window && j > 0u && frames[j - 1u].offset + window >= boundary; j--) {
+                if (same_frame(frames[j - 1u], f, tolerance)) {
+                    duplicate = true;
+                    break;
+                }
+            }
+
+            if (duplicate)
+                duplicates++;
+            else
+                frames.push_back(f);
+        }
+    }
+
+    for (const offline_frame_t& f : frames) {
+        std::cout << f.offset << " " << std::fixed << std::setprecision(6) << f.offset / o.samp_rate << " "
+                  << f.frame->payload_length() << " " << std::hex << std::setfill('0');
+        for (uint32_t i = 0u; i < f.frame->payload_length(); i++)
+            std::cout << std::setw(2) << (int)f.frame->payload()[i];
+        std::cout << std::dec << std::setfill(' ') << std::endl;
+    }
+
+    const double signal_seconds = length / o.samp_rate;
+    std::cerr << "samples:            " << length << " (" << signal_seconds << " s of signal)" << std::endl
+              << "chunks:             " << num_chunks << " of " << chunk << " samples, overlap " << overlap << std::endl
+              << "threads:            " << threads << std::endl
+              << "frames:             " << frames.size() << " (" << duplicates << " duplicates dropped)" << std::endl
+              << "wall time:          " << wall << " s" << std::endl
+              << "real-time factor:   " << signal_seconds / wall << std::endl;
+
+    return 0;
+}
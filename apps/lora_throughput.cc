@@ -0,0 +1,281 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * End-to-end throughput of the receive chain. Runs a capture, or synthetic frames from the encoder, through
+ * one channelizer and decoder per channel as fast as the machine allows (no throttle), then reports the
+ * real-time factor, decoded frames per second, CPU time per stage and peak RSS:
+ *
+ *     lora_throughput --file capture.sigmf-data --samp-rate 1e6 --center-freq 868e6 --channels 868.1e6 --sf 7
+ *     lora_throughput --generate 1000 --samp-rate 1e6 --sf 9 --cr 4
+ *
+ * Captures are SigMF recordings or raw files of complex float32, int16 or int8 samples, replayed from a memory mapping.
+ * Synthetic frames are modulated on the fly by a `modulator` block, so that the input never sits in memory.
+ */
+
+#include <lora/channelizer.h>
+#include <lora/decoder.h>
+#include <lora/encoder.h>
+#include <lora/logging.h>
+#include <lora/modulator.h>
+#include <lora/sigmf_source.h>
+#include <gnuradio/block.h>
+#include <gnuradio/high_res_timer.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/prefs.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/head.h>
+#include <boost/bind/bind.hpp>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+#define SYNTHETIC_GAP_SYMBOLS 16u   ///< Silence between generated frames.
+
+namespace {
+
+    /**
+     *  \brief  Counts the frames published by the decoders.
+     */
+    class frame_counter : public gr::block {
+        public:
+            typedef std::shared_ptr<frame_counter> sptr;
+
+            static sptr make() {
+                return gnuradio::get_initial_sptr(new frame_counter());
+            }
+
+            uint64_t count() const { return d_count; }
+
+        private:
+            std::atomic<uint64_t> d_count;
+
+            frame_counter()
+                : gr::block("frame_counter", gr::io_signature::make(0, 0, 0), gr::io_signature::make(0, 0, 0)),
+                  d_count(0u) {
+                message_port_register_in(pmt::mp("in"));
+                set_msg_handler(pmt::mp("in"), boost::bind(&frame_counter::handle, this, boost::placeholders::_1));
+            }
+
+            void handle(pmt::pmt_t msg) {
+                (void) msg;
+                d_count++;
+            }
+    };
+
+    typedef struct options {
+        std::string        file;
+        std::string        format;                  ///< Sample format of the file, if not in its metadata.
+        uint32_t           generate      = 0u;      ///< Number of synthetic frames, if no file is given.
+        uint32_t           payload_len   = 16u;
+        uint32_t           repeat        = 1u;
+        double             samp_rate     = 1e6;
+        double             center_freq   = 868e6;
+        std::vector<float> channels;                ///< Defaults to the center frequency.
+        uint32_t           bandwidth     = 125000u;
+        uint32_t           sf            = 7u;
+        uint32_t           cr            = 4u;
+        bool               crc           = true;
+        bool               implicit      = false;
+        bool               reduced_rate  = false;
+        uint32_t           decimation    = 1u;
+        bool               verbose       = false;
+    } options_t;
+
+    void usage(const char* name) {
+        std::cerr << "Usage: " << name << " (--file capture | --generate frames) [options]" << std::endl
+                  << "  --file path           SigMF recording or raw samples" << std::endl
+                  << "  --format f            Sample format of a raw file: cf32 (default), ci16 or ci8" << std::endl
+                  << "  --generate n          Decode n synthetic frames instead of a file" << std::endl
+                  << "  --payload-len n       Payload length of synthetic frames (16)" << std::endl
+                  << "  --repeat n            Feed the input n times (1)" << std::endl
+                  << "  --samp-rate hz        Sample rate of the input (1e6)" << std::endl
+                  << "  --center-freq hz      Center frequency of the input (868e6)" << std::endl
+                  << "  --channels hz,...     Channels to decode, one decoder each (center frequency)" << std::endl
+                  << "  --bandwidth hz        Channel bandwidth (125000)" << std::endl
+                  << "  --sf n --cr n         Spreading factor (7) and coding rate (4)" << std::endl
+                  << "  --no-crc --implicit --reduced-rate" << std::endl
+                  << "  --decimation n        Channelizer decimation (1)" << std::endl
+                  << "  --verbose             Keep printing decoded frames" << std::endl;
+    }
+
+    bool parse(int argc, char** argv, options_t& o) {
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+            if (arg == "--no-crc")            { o.crc = false;          continue; }
+            if (arg == "--implicit")          { o.implicit = true;      continue; }
+            if (arg == "--reduced-rate")      { o.reduced_rate = true;  continue; }
+            if (arg == "--verbose")           { o.verbose = true;       continue; }
+            if (!value)
+                return false;
+
+            if      (arg == "--file")         o.file         = value;
+            else if (arg == "--format")       o.format       = value;
+            else if (arg == "--generate")     o.generate     = atoi(value);
+            else if (arg == "--payload-len")  o.payload_len  = atoi(value);
+            else if (arg == "--repeat")       o.repeat       = atoi(value);
+            else if (arg == "--samp-rate")    o.samp_rate    = atof(value);
+            else if (arg == "--center-freq")  o.center_freq  = atof(value);
+            else if (arg == "--bandwidth")    o.bandwidth    = atoi(value);
+            else if (arg == "--sf")           o.sf           = atoi(value);
+            else if (arg == "--cr")           o.cr           = atoi(value);
+            else if (arg == "--decimation")   o.decimation   = atoi(value);
+            else if (arg == "--channels") {
+                std::stringstream ss(value);
+                std::string item;
+                while (std::getline(ss, item, ','))
+                    o.channels.push_back(atof(item.c_str()));
+            } else {
+                return false;
+            }
+            i++;
+        }
+
+        if (o.channels.empty())
+            o.channels.push_back(o.center_freq);
+
+        return (!o.file.empty() || o.generate > 0u) && o.repeat > 0u && o.payload_len <= 255u;
+    }
+
+    double cpu_seconds(const struct rusage& r) {
+        return r.ru_utime.tv_sec + r.ru_utime.tv_usec / 1e6 + r.ru_stime.tv_sec + r.ru_stime.tv_usec / 1e6;
+    }
+
+    double work_seconds(const gr::block_sptr& b) {
+        return b->pc_work_time_total() / (double)gr::high_res_timer_tps();
+    }
+}
+
+int main(int argc, char** argv) {
+    options_t o;
+    if (!parse(argc, argv, o)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // Per-block work time, measured as thread CPU time
+    gr::prefs::singleton()->set_bool("PerfCounters", "on", true);
+    gr::prefs::singleton()->set_string("PerfCounters", "clock", "thread");
+
+    if (!o.verbose)
+        gr::lora::set_log_level(gr::lora::log_category::FRAME, gr::lora::log_level::WARN);
+
+    gr::top_block_sptr tb = gr::make_top_block("lora_throughput");
+    gr::block_sptr source;
+    uint64_t num_samples;
+
+    if (!o.file.empty()) {
+        gr::lora::sigmf_source::sptr file;
+        try {
+            file = gr::lora::sigmf_source::make(o.file, o.format, o.repeat > 1u);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+
+        num_samples = file->length() * o.repeat;
+        source = file;
+    } else {
+        // Only used for the frame length; the payloads are modulated by the source block while it runs
+        const gr::lora::encoder enc(o.samp_rate, o.bandwidth, o.sf, o.cr, o.crc, o.implicit, o.reduced_rate);
+        gr::lora::modulator::sptr mod = gr::lora::modulator::make(o.samp_rate, o.bandwidth, o.sf, o.cr, o.crc, o.implicit, o.reduced_rate,
+                                                                  ENCODER_DEFAULT_PREAMBLE_LEN, ENCODER_DEFAULT_SYNC_WORD, SYNTHETIC_GAP_SYMBOLS);
+        std::vector<uint8_t> payload(o.payload_len);
+
+        // Every repetition sends the same frames
+        for (uint32_t r = 0u; r < o.repeat; r++) {
+            std::mt19937 rng(1u);
+
+            for (uint32_t i = 0u; i < o.generate; i++) {
+                for (uint8_t& b : payload)
+                    b = rng();
+
+                mod->queue_frame(payload);
+            }
+        }
+
+        num_samples = (uint64_t)o.generate * o.repeat * (enc.frame_length(o.payload_len) + SYNTHETIC_GAP_SYMBOLS * enc.samples_per_symbol());
+        source = mod;
+        o.channels.assign(1u, o.center_freq);   // Generated at baseband
+    }
+
+    // The modulator never ends, and a repeated file loops
+    gr::basic_block_sptr input = source;
+    if (o.repeat > 1u || o.file.empty()) {
+        input = gr::blocks::head::make(sizeof(gr_complex), num_samples);
+        tb->connect(source, 0, input, 0);
+    }
+
+    frame_counter::sptr counter = frame_counter::make();
+    std::vector<gr::block_sptr> decoders;
+
+    for (float channel : o.channels) {
+        gr::lora::channelizer::sptr ch = gr::lora::channelizer::make(o.samp_rate, o.center_freq, std::vector<float>(1u, channel), o.bandwidth, o.decimation);
+        gr::lora::decoder::sptr dec = gr::lora::decoder::make(o.samp_rate / o.decimation, o.bandwidth, o.sf, o.implicit, o.cr, o.crc, o.reduced_rate, false);
+
+        tb->connect(input, 0, ch, 0);
+        tb->connect(ch, 0, dec, 0);
+        tb->msg_connect(dec, "frame_refs", counter, "in");
+        decoders.push_back(dec);
+    }
+
+    struct rusage usage_start, usage_end;
+    getrusage(RUSAGE_SELF, &usage_start);
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    tb->run();
+
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    getrusage(RUSAGE_SELF, &usage_end);
+
+    const double cpu_total  = cpu_seconds(usage_end) - cpu_seconds(usage_start);
+    const double cpu_source = work_seconds(source);
+    double cpu_decoders = 0.0;
+    for (const gr::block_sptr& dec : decoders)
+        cpu_decoders += work_seconds(dec);
+
+    const double signal_seconds = num_samples / o.samp_rate;
+
+    std::cout << std::endl
+              << "samples:            " << num_samples << " (" << signal_seconds << " s of signal)" << std::endl
+              << "channels:           " << o.channels.size() << std::endl
+              << "wall time:          " << wall << " s" << std::endl
+              << "real-time factor:   " << signal_seconds / wall << std::endl
+              << "frames:             " << counter->count() << std::endl
+              << "frames/s:           " << counter->count() / wall << std::endl
+              << "cpu total:          " << cpu_total << " s" << std::endl
+              << "cpu source:         " << cpu_source << " s" << std::endl;
+
+    for (size_t i = 0u; i < decoders.size(); i++)
+        std::cout << "cpu decoder " << i << ":      " << work_seconds(decoders[i]) << " s" << std::endl;
+
+    // The channelizer is a hierarchical block, so its filter is not timed on its own
+    std::cout << "cpu channelizer:    " << std::max(cpu_total - cpu_source - cpu_decoders, 0.0) << " s (remainder, includes scheduler)" << std::endl
+              << "peak rss:           " << usage_end.ru_maxrss / 1024.0 << " MiB" << std::endl;
+
+    return 0;
+}
@@ -22,32 +22,72 @@
 #define INCLUDED_DEBUGGER_H
 
 #include <gnuradio/gr_complex.h>
+#include <boost/thread.hpp>
+#include <atomic>
+#include <memory>
+#include <string>
 #include <vector>
 #include <stdint.h>
 
 #define PACKED __attribute__((packed, aligned(1)))
 
+#define DEBUGGER_DEFAULT_SNAPSHOTS   16u        ///< Snapshots that may wait for the analyzer.
+#define DEBUGGER_DEFAULT_MAX_SAMPLES (1u << 16) ///< Samples kept per snapshot.
+
 namespace gr {
     namespace lora {
+        /**
+         *  \brief  Tap that streams sample snapshots to `grlora_analyze.py` over a UNIX domain socket.
+         *          <br/>`store_samples` and `analyze_samples` only copy into buffers allocated by `attach` and
+         *          freed by `detach`; a separate thread does the socket I/O. When the analyzer falls behind,
+         *          the oldest pending snapshot is dropped, so a slow or stalled analyzer never blocks the caller.
+         */
         class debugger {
         public:
-            debugger();
+            debugger(uint32_t num_snapshots = DEBUGGER_DEFAULT_SNAPSHOTS, uint32_t max_samples = DEBUGGER_DEFAULT_MAX_SAMPLES);
             virtual ~debugger();
 
             void attach(std::string path = "/tmp/gr_lora.sock");
             void detach(void);
             void analyze_samples(bool clear, bool draw_over);
             void store_samples(const gr_complex* samples, uint32_t length);
+
+            uint64_t num_sent() const;          ///< Snapshots written to the socket.
+            uint64_t num_dropped() const;       ///< Snapshots overwritten before they could be sent.
+            uint64_t num_truncated() const;     ///< Samples discarded because a snapshot was full.
         private:
             typedef struct header {
                 uint32_t length;
                 bool draw_over;
             } PACKED header;
 
+            typedef struct snapshot {
+                std::vector<gr_complex> samples;    ///< `d_max_samples` while attached, else empty; only `length` are valid.
+                uint32_t length;
+                bool draw_over;
+            } snapshot;
+
             void send_samples();
-            std::vector<gr_complex> d_samples;
+            bool send_all(const void* data, size_t length);
+
+            const uint32_t d_max_samples;
+            snapshot d_staging;                     ///< Samples collected by `store_samples`, owned by the caller's thread.
+            snapshot d_sending;                     ///< Snapshot being written by the sender thread.
+
+            std::vector<snapshot> d_ring;           ///< Snapshots waiting to be sent.
+            uint32_t d_ring_head;                   ///< Index of the oldest pending snapshot.
+            uint32_t d_ring_count;                  ///< Number of pending snapshots.
+            boost::mutex d_mutex;                   ///< Protects the ring and `d_running`.
+            boost::condition_variable d_cond;
+            std::shared_ptr<boost::thread> d_thread;
+            bool d_running;
+
+            std::atomic<uint64_t> d_sent;
+            std::atomic<uint64_t> d_dropped;
+            std::atomic<uint64_t> d_truncated;
+
             int d_socket;
-            bool d_attached;
+            std::atomic<bool> d_attached;
         };
     }
 }
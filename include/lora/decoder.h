@@ -680,17 +680,47 @@
 #define INCLUDED_LORA_DECODER_H
 
 #include <lora/api.h>
-#include <gnuradio/sync_block.h>
+#include <gnuradio/block.h>
+#include <map>
+#include <string>
+#include <vector>
 
 namespace gr {
   namespace lora {
 
     /*!
-     * \brief <+description of block+>
+     * \brief Decodes LoRa frames from complex baseband samples.
      * \ingroup lora
      *
+     * Decoded frames are published as LoRaTap blobs on the `frames` port.
+     * If the source tags its samples with `rx_time`, as UHD sources do, the
+     * frames record when their preamble arrived at the radio, and latencies
+     * are measured from there; the radio time must then follow the host
+     * clock. Otherwise latencies only cover the time spent decoding.
+     * C++ blocks can subscribe to `frame_refs` instead, which carries the
+     * same frames as `lora::frame` references, without copying them (see
+     * `frame_from_pmt`).
+     * The optional byte output carries the same PHY payloads as a stream;
+     * the first byte of every payload is tagged with `packet_len`, `snr` (dB),
+     * `cfo` (Hz), `sf`, `sample_offset` (the input sample at which the
+     * frame was synchronized) and `inverted_iq`.
+     *
+     * Decoding is done by a `lora::phy_decoder`, which always counts where
+     * its time goes: ticks (TSC cycles on x86, nanoseconds elsewhere) and
+     * steps of the state machine per state, with a log2 histogram of ticks
+     * per step, and the number of symbols, detections, SFD
+     * searches, synchronization aborts, headers and payloads. The scalar
+     * counters and the per-state load are also exported to ControlPort.
+     *
+     * Once per second by default, a dictionary is published on the `stats`
+     * port, from a thread of its own so that it keeps coming while the input
+     * stalls, with the counters (`detections`, `sync_losses`, `headers`,
+     * `payloads`, `symbols`), the mean `snr` (dB) of the payloads with a
+     * finite SNR since the previous message (NaN if none), the `cpu` seconds
+     * used by the decoder thread and their share of wall time (`load`) over
+     * the `interval`, and the input `backlog` in samples.
      */
-    class LORA_API decoder : virtual public gr::sync_block {
+    class LORA_API decoder : virtual public gr::block {
      public:
       typedef std::shared_ptr<decoder> sptr;
 
@@ -706,6 +736,49 @@ namespace gr {
 
       virtual void set_sf(uint8_t sf) = 0;
       virtual void set_samp_rate(float samp_rate) = 0;
+
+      //! Symbols worth of input samples consumed.
+      virtual uint64_t num_symbols() = 0;
+      //! Preambles detected.
+      virtual uint64_t num_detections() = 0;
+      //! Transitions from SYNC to FIND_SFD.
+      virtual uint64_t num_sfd_searches() = 0;
+      //! Returns to DETECT because the SFD was not found.
+      virtual uint64_t num_sync_aborts() = 0;
+      //! Returns to DETECT because the sync word was not accepted.
+      virtual uint64_t num_sync_word_aborts() = 0;
+      //! Explicit headers decoded.
+      virtual uint64_t num_headers() = 0;
+      //! Returns to DETECT because the explicit header checksum did not match.
+      virtual uint64_t num_header_aborts() = 0;
+      //! Frames decoded without header by `set_autodetect`, because their header did not check out.
+      virtual uint64_t num_inferred_implicit() = 0;
+      //! Payloads decoded and published.
+      virtual uint64_t num_payloads() = 0;
+      //! Payloads whose MAC CRC did not match, published or not.
+      virtual uint64_t num_crc_errors() = 0;
+      //! Returns to DETECT because the payload symbols faded into noise or lost their shape.
+      virtual uint64_t num_payload_aborts() = 0;
+      //! Frames dropped after their SFD because every packet context was busy with another frame.
+      virtual uint64_t num_context_aborts() = 0;
+      //! Ticks spent per state, keyed by state name (e.g. "DETECT").
+      virtual std::map<std::string, uint64_t> state_ticks() = 0;
+      //! Steps of the state machine per state, keyed by state name.
+      virtual std::map<std::string, uint64_t> state_visits() = 0;
+      //! Steps in the given state; element i counts steps of 2^i to 2^(i+1) ticks.
+      virtual std::vector<uint64_t> state_histogram(const std::string& state) = 0;
+      //! Zero all counters. Takes effect at the next step.
+      virtual void reset_counters() = 0;
+      //! Seconds between two messages on the `stats` port; 0 disables them.
+      virtual void set_stats_interval(double seconds) = 0;
+      //! Publish only frames whose MAC CRC matches, or that have none. Off by default.
+      virtual void set_drop_invalid(bool drop) = 0;
+      //! Publish only frames with one of these sync words; empty, the default, accepts any.
+      virtual void set_sync_words(const std::vector<uint8_t>& sync_words) = 0;
+      //! Also decode frames with inverted IQ, i.e. both uplink and downlink. Off by default.
+      virtual void set_dual_polarity(bool dual) = 0;
+      //! Infer the header mode and low data rate optimization of each frame. Off by default.
+      virtual void set_autodetect(bool autodetect) = 0;
     };
 
   } // namespace lora
@@ -0,0 +1,137 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LORA_ENCODER_H
+#define INCLUDED_LORA_ENCODER_H
+
+#include <lora/api.h>
+#include <gnuradio/gr_complex.h>
+#include <complex>
+#include <vector>
+#include <stdint.h>
+
+#define ENCODER_DEFAULT_PREAMBLE_LEN    8u      ///< Upchirps before the sync word.
+#define ENCODER_DEFAULT_SYNC_WORD       0x12    ///< Private network sync word.
+
+namespace gr {
+    namespace lora {
+
+        /**
+         *  \brief  LoRa PHY transmitter, the inverse of the decoder: a payload is extended with the explicit
+         *          header and MAC CRC, whitened with the tables the decoder uses, Hamming coded, shuffled,
+         *          interleaved and Gray mapped to chirp shifts. `modulate` then synthesizes the frame at the
+         *          given sample rate as phase continuous chirps, from a step table computed once.
+         *          <br/>Used to generate test and benchmark vectors without a radio.
+         */
+        class LORA_API encoder {
+            public:
+                /**
+                 *  \param  samp_rate
+                 *          Output sample rate. Must be an integer multiple of `bandwidth`.
+                 *  \param  bandwidth
+                 *          Chirp bandwidth.
+                 *  \param  sf
+                 *          Spreading factor, between 6 and 12. Explicit headers need at least 7.
+                 *  \param  cr
+                 *          Coding rate 4/(4+cr) of the payload, between 1 and 4.
+                 *  \param  crc
+                 *          Append the MAC CRC.
+                 *  \param  implicit
+                 *          Leave out the explicit header.
+                 *  \param  reduced_rate
+                 *          Low data rate optimization: only `sf - 2` bits per payload symbol.
+                 *  \param  preamble_len
+                 *          Number of upchirps in the preamble.
+                 *  \param  sync_word
+                 *          Sync word, sent as two upchirps shifted by each nibble times 8.
+                 */
+                encoder(float samp_rate, uint32_t bandwidth, uint8_t sf, uint8_t cr = 4, bool crc = true,
+                        bool implicit = false, bool reduced_rate = false,
+                        uint16_t preamble_len = ENCODER_DEFAULT_PREAMBLE_LEN, uint8_t sync_word = ENCODER_DEFAULT_SYNC_WORD);
+
+                /**
+                 *  \brief  Number of header and payload symbols of a frame, excluding the preamble.
+                 */
+                uint32_t num_symbols(uint32_t length) const;
+
+                /**
+                 *  \brief  Number of samples `modulate` produces for a payload of the given length.
+                 */
+                uint32_t frame_length(uint32_t length) const;
+
+                /**
+                 *  \brief  Compute the chirp shift of every header and payload symbol, in chips. The preamble, sync
+                 *          word and SFD are not included.
+                 *
+                 *  \param  payload
+                 *          The payload, without MAC CRC.
+                 *  \param  length
+                 *          The length of the payload, at most 255.
+                 *  \param  shifts
+                 *          Replaced with `num_symbols(length)` shifts.
+                 */
+                void encode(const uint8_t* payload, uint32_t length, std::vector<uint32_t>& shifts);
+
+                /**
+                 *  \brief  Append the baseband samples of a complete frame: preamble, sync word, 2.25 downchirps,
+                 *          header and payload. The phase carries over from the previous frame.
+                 *
+                 *  \param  payload
+                 *          The payload, without MAC CRC.
+                 *  \param  length
+                 *          The length of the payload, at most 255.
+                 *  \param  out
+                 *          The vector to append `frame_length(length)` samples to.
+                 */
+                void modulate(const uint8_t* payload, uint32_t length, std::vector<gr_complex>& out);
+
+                uint32_t samples_per_symbol() const { return d_samples_per_symbol; }
+
+            private:
+                uint8_t codeword(uint8_t nibble, bool full) const;
+                void    interleave(const uint8_t* codewords, uint32_t ppm, uint32_t bits, bool reduced_rate, std::vector<uint32_t>& shifts) const;
+                void    chirp(uint32_t shift, bool down, uint32_t length, gr_complex* out);
+
+                uint8_t  d_sf;
+                uint8_t  d_cr;
+                bool     d_crc;
+                bool     d_implicit;
+                bool     d_reduced_rate;
+                uint16_t d_preamble_len;
+                uint8_t  d_sync_word;
+
+                uint32_t d_number_of_bins;
+                uint32_t d_decim_factor;                    ///< Samples per chip.
+                uint32_t d_samples_per_symbol;
+
+                const uint8_t* d_prng;                      ///< Whitening table matching `d_cr`, as selected by the decoder.
+                uint32_t       d_prng_length;
+
+                std::vector<std::complex<double>> d_step;   ///< Per-sample phase rotation of an unshifted upchirp.
+                std::complex<double>              d_phase;  ///< Current carrier phase, continuous across symbols and frames.
+
+                std::vector<uint8_t>  d_nibbles;            ///< Scratch: payload and CRC nibbles, low nibble first.
+                std::vector<uint8_t>  d_codewords;          ///< Scratch: codewords of the current block.
+                std::vector<uint32_t> d_shifts;             ///< Scratch: symbols of the frame being modulated.
+        };
+    }
+}
+
+#endif /* INCLUDED_LORA_ENCODER_H */
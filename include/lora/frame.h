@@ -0,0 +1,190 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LORA_FRAME_H
+#define INCLUDED_LORA_FRAME_H
+
+#include <lora/api.h>
+#include <lora/loratap.h>
+#include <lora/loraphy.h>
+#include <pmt/pmt.h>
+#include <boost/intrusive_ptr.hpp>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#define LORA_FRAME_MAX_PAYLOAD  (255u + 2u)    // PHY payload including the MAC CRC
+#define LORA_FRAME_MAX_SIZE     (sizeof(loratap_header_t) + sizeof(loraphy_header_t) + LORA_FRAME_MAX_PAYLOAD)
+
+namespace gr {
+    namespace lora {
+        class frame_pool;
+
+        /**
+         *  \brief  When a frame passed the decoder, as absolute input sample indices and wall clock times in
+         *          nanoseconds since the UNIX epoch. All zero if unknown.
+         */
+        typedef struct frame_timing {
+            uint64_t detect_sample;                         ///< Start of the symbol in which the preamble was detected.
+            uint64_t sync_sample;                           ///< First sample of the upchirp the decoder synchronized to.
+            uint64_t sfd_sample;                            ///< Start of the symbol in which the SFD was found.
+            uint64_t publish_sample;                        ///< Input position when the frame was published.
+            uint64_t arrival_ns;                            ///< When the radio received the last sample of the detected preamble symbols, from an `rx_time` tag.
+            uint64_t detect_ns;                             ///< When the decoder got to those samples, after any queueing.
+            uint64_t sfd_ns;
+            uint64_t publish_ns;
+        } frame_timing_t;
+
+        /**
+         *  \brief  The time latencies are measured from: the arrival at the radio if known, else the detection, in
+         *          which case they only cover the time spent decoding.
+         */
+        inline uint64_t latency_origin_ns(const frame_timing_t& timing) {
+            return timing.arrival_ns ? timing.arrival_ns : timing.detect_ns;
+        }
+
+        /**
+         *  \brief  What the decoder measured of the channel a frame was received on.
+         */
+        typedef struct frame_channel {
+            float snr;                                      ///< Signal to noise ratio in dB, over the preamble. NaN if no noise was measured before it.
+            float cfo;                                      ///< Coarse carrier frequency offset in Hz, 0 unless estimated.
+            bool  inverted_iq;                              ///< Received with inverted IQ, as LoRaWAN downlinks are sent.
+        } frame_channel_t;
+
+        /**
+         *  \brief  Outcome of the MAC CRC check of a frame.
+         */
+        enum class crc_status : uint8_t {
+            NONE,                                           ///< Not checked: the frame has no MAC CRC, or an implicit header.
+            VALID,
+            INVALID
+        };
+
+        /**
+         *  \brief  A decoded LoRa frame laid out as a LoRaTap packet: `loratap_header_t | loraphy_header_t | payload`.
+         *          <br/>Frames are reference counted and handed out by a `frame_pool`. When the last reference
+         *          is released, the frame returns to its pool instead of being freed.
+         */
+        class LORA_API frame {
+            public:
+                frame();
+
+                const uint8_t*          data()          const { return d_data; }
+                uint32_t                size()          const { return sizeof(loratap_header_t) + sizeof(loraphy_header_t) + d_payload_length; }
+
+                loratap_header_t*       loratap_header()      { return reinterpret_cast<loratap_header_t*>(d_data); }
+                const loratap_header_t* loratap_header() const { return reinterpret_cast<const loratap_header_t*>(d_data); }
+                loraphy_header_t*       phy_header()          { return reinterpret_cast<loraphy_header_t*>(d_data + sizeof(loratap_header_t)); }
+                const loraphy_header_t* phy_header()     const { return reinterpret_cast<const loraphy_header_t*>(d_data + sizeof(loratap_header_t)); }
+                uint8_t*                payload()             { return d_data + sizeof(loratap_header_t) + sizeof(loraphy_header_t); }
+                const uint8_t*          payload()        const { return d_data + sizeof(loratap_header_t) + sizeof(loraphy_header_t); }
+
+                frame_timing_t&         timing()              { return d_timing; }
+                const frame_timing_t&   timing()         const { return d_timing; }
+                frame_channel_t&        channel()             { return d_channel; }
+                const frame_channel_t&  channel()        const { return d_channel; }
+                crc_status              crc()            const { return d_crc; }
+                void                    set_crc(crc_status crc) { d_crc = crc; }
+
+                uint32_t                payload_length() const { return d_payload_length; }
+                void                    set_payload_length(uint32_t length) { d_payload_length = std::min(length, LORA_FRAME_MAX_PAYLOAD); }
+
+            private:
+                friend class frame_pool;
+                friend LORA_API void intrusive_ptr_add_ref(frame* f);
+                friend LORA_API void intrusive_ptr_release(frame* f);
+
+                std::atomic<uint32_t>       d_refcount;
+                std::shared_ptr<frame_pool> d_pool;             ///< Pool to return to, or empty for frames allocated after the pool ran dry.
+                uint32_t                    d_payload_length;
+                frame_timing_t              d_timing;           ///< Travels with the frame, outside of the LoRaTap bytes.
+                frame_channel_t             d_channel;          ///< Likewise, at full precision.
+                crc_status                  d_crc;
+                uint8_t                     d_data[LORA_FRAME_MAX_SIZE];
+        };
+
+        typedef boost::intrusive_ptr<frame> frame_sptr;
+
+        LORA_API void intrusive_ptr_add_ref(frame* f);
+        LORA_API void intrusive_ptr_release(frame* f);
+
+        /**
+         *  \brief  Fixed set of preallocated frames, so that publishing a frame does not allocate its buffer.
+         *          <br/>Frames may be released from any thread. If all frames are in use, `acquire`
+         *          falls back to the heap and counts the event.
+         */
+        class LORA_API frame_pool : public std::enable_shared_from_this<frame_pool> {
+            public:
+                typedef std::shared_ptr<frame_pool> sptr;
+
+                static sptr make(uint32_t num_frames);
+
+                frame_sptr acquire();
+                uint32_t   available();
+                uint64_t   num_exhausted() const { return d_exhausted; }
+
+                explicit frame_pool(uint32_t num_frames);
+
+            private:
+                friend LORA_API void intrusive_ptr_release(frame* f);
+
+                void recycle(frame* f);
+
+                std::unique_ptr<frame[]> d_frames;
+                std::vector<frame*>      d_free;
+                std::mutex               d_mutex;
+                std::atomic<uint64_t>    d_exhausted;
+        };
+
+        /**
+         *  \brief  Copy the LoRaTap bytes of a frame into a PMT blob, the message format of a `frames` port.
+         */
+        LORA_API pmt::pmt_t frame_to_blob(const frame_sptr& f);
+
+        /**
+         *  \brief  Wrap a frame in a PMT without copying it, the message format of a `frame_refs` port.
+         *          Only C++ blocks can read it, through `frame_from_pmt` or `frame_view`.
+         */
+        LORA_API pmt::pmt_t frame_to_pmt(const frame_sptr& f);
+
+        /**
+         *  \brief  Return the frame carried by the given PMT, or an empty pointer if it holds something else.
+         */
+        LORA_API frame_sptr frame_from_pmt(const pmt::pmt_t& msg);
+
+        /**
+         *  \brief  Access the LoRaTap bytes of a message, either a pooled frame or a plain blob.
+         *
+         *  \param  msg
+         *          The message received on a `frames` or `frame_refs` port.
+         *  \param  data
+         *          Set to the first byte of the LoRaTap packet.
+         *  \param  size
+         *          Set to the length of the LoRaTap packet.
+         *  \return Whether the message contained a frame.
+         */
+        LORA_API bool frame_view(const pmt::pmt_t& msg, const uint8_t** data, size_t* size);
+    }
+}
+
+#endif /* INCLUDED_LORA_FRAME_H */
@@ -0,0 +1,83 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LORA_LATENCY_H
+#define INCLUDED_LORA_LATENCY_H
+
+#include <lora/api.h>
+#include <pmt/pmt.h>
+#include <chrono>
+#include <stdint.h>
+#include <vector>
+
+#define LATENCY_HISTOGRAM_BINS 32u  ///< Power-of-two microsecond buckets, the last one reaching over an hour.
+
+namespace gr {
+    namespace lora {
+
+        /**
+         *  \brief  Points in the life of a frame whose delay after preamble detection is recorded.
+         */
+        enum class latency_stage : uint8_t {
+            SFD,                ///< The decoder found the start frame delimiter.
+            PUBLISH,            ///< The decoder published the frame on its `frames` port.
+            SOCKET_SINK,        ///< A `message_socket_sink` sent the frame.
+            FILE_SINK,          ///< A `message_file_sink` wrote the frame.
+            NUM_STAGES
+        };
+
+        /**
+         *  \brief  Return the wall clock time in nanoseconds since the UNIX epoch, as used for frame timestamps.
+         */
+        inline uint64_t wall_time_ns() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
+        /**
+         *  \brief  Add a latency to the process-wide histogram of a stage. Safe to call from any thread.
+         *          Negative values, from the wall clock stepping back, count as zero.
+         */
+        LORA_API void record_latency(latency_stage stage, int64_t ns);
+
+        /**
+         *  \brief  Record the time since the detection of the frame carried by `msg` for a stage. Messages that
+         *          are not pooled frames, such as plain blobs, carry no timestamps and are ignored.
+         */
+        LORA_API void record_frame_latency(latency_stage stage, const pmt::pmt_t& msg);
+
+        /**
+         *  \brief  Return the latency histogram of a stage: bucket `i` counts latencies of `[2^i, 2^(i+1))`
+         *          microseconds, bucket 0 also counts shorter ones and the last bucket also counts longer ones.
+         */
+        LORA_API std::vector<uint64_t> latency_histogram(latency_stage stage);
+
+        /**
+         *  \brief  Return the mean latency of a stage in microseconds, or 0 if nothing was recorded.
+         */
+        LORA_API double latency_mean(latency_stage stage);
+
+        /**
+         *  \brief  Clear the histograms of all stages.
+         */
+        LORA_API void reset_latency();
+    }
+}
+
+#endif /* INCLUDED_LORA_LATENCY_H */
@@ -0,0 +1,85 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LORA_LOGGING_H
+#define INCLUDED_LORA_LOGGING_H
+
+#include <lora/api.h>
+#include <stdint.h>
+#include <string>
+
+namespace gr {
+    namespace lora {
+
+        /**
+         *  \brief  Subsystems that can be logged independently.
+         */
+        enum class log_category : uint8_t {
+            SYNC,               ///< Preamble detection and synchronization.
+            DEMOD,              ///< Symbol demodulation.
+            DECODE,             ///< Deinterleaving, dewhitening and FEC.
+            FRAME,              ///< Decoded headers and payloads.
+            NUM_CATEGORIES
+        };
+
+        /**
+         *  \brief  Log levels, from least to most verbose.
+         */
+        enum class log_level : uint8_t {
+            OFF,
+            ERROR,
+            WARN,
+            INFO,
+            DEBUG,
+            TRACE
+        };
+
+        /**
+         *  \brief  Set the most verbose level logged for a category. Takes effect immediately, from any thread.
+         */
+        LORA_API void set_log_level(log_category category, log_level level);
+
+        /**
+         *  \brief  Return the current level of a category.
+         */
+        LORA_API log_level get_log_level(log_category category);
+
+        /**
+         *  \brief  Set levels from a specification such as `sync=debug,frame=info`. A bare level applies to all
+         *          categories. The `GRLORA_LOG` environment variable is parsed the same way at load time.
+         *
+         *  \return Whether the whole specification was understood.
+         */
+        LORA_API bool set_log_levels(const std::string& spec);
+
+        /**
+         *  \brief  Write log records to the given file instead of standard output. An empty path restores
+         *          standard output. Defaults to the `GRLORA_LOG_FILE` environment variable.
+         */
+        LORA_API void set_log_file(const std::string& path);
+
+        /**
+         *  \brief  Number of records discarded because the formatter thread could not keep up.
+         */
+        LORA_API uint64_t log_dropped();
+    }
+}
+
+#endif /* INCLUDED_LORA_LOGGING_H */
@@ -18,6 +18,9 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#ifndef INCLUDED_LORA_LORAPHY_H
+#define INCLUDED_LORA_LORAPHY_H
+
 #include <stdint.h>
 
 typedef enum cr { CR1=1, CR2, CR3, CR4 } cr_t;
@@ -30,3 +33,5 @@ typedef struct __attribute__((__packed__)) loraphy_header {
     uint8_t crc_lsn : 4;
     uint8_t reserved : 4;
 } loraphy_header_t;
+
+#endif /* INCLUDED_LORA_LORAPHY_H */
@@ -15,6 +15,9 @@ You should have received a copy of the GNU General Public License
 along with LoRaTap.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#ifndef INCLUDED_LORA_LORATAP_H
+#define INCLUDED_LORA_LORATAP_H
+
 #include <stdint.h>
 
 /*
@@ -53,3 +56,5 @@ typedef struct __attribute__((__packed__)) loratap_header {
 	loratap_rssi_t			rssi;
 	uint8_t				sync_word;	/* LoRa radio sync word [0x34 = LoRaWAN] */
 } loratap_header_t;
+
+#endif /* INCLUDED_LORA_LORATAP_H */
@@ -0,0 +1,74 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LORA_MESSAGE_MONGODB_SINK_H
+#define INCLUDED_LORA_MESSAGE_MONGODB_SINK_H
+
+#include <lora/api.h>
+#include <gnuradio/block.h>
+#include <string>
+
+namespace gr {
+    namespace lora {
+        /*!
+         * \brief Sink for LoRaTap frames, stored in a MongoDB collection.
+         *
+         * Frames are queued by the message handler and written with bulk
+         * inserts from a background thread. The queue is bounded: when the
+         * database cannot keep up, the oldest queued frames are dropped.
+         *
+         * \ingroup lora
+         */
+        class LORA_API message_mongodb_sink : virtual public gr::block {
+            public:
+                typedef std::shared_ptr<message_mongodb_sink> sptr;
+
+                /*!
+                 * \brief Return a shared_ptr to a new instance of lora::message_mongodb_sink.
+                 *
+                 * \param ip          Address of the MongoDB server.
+                 * \param port        Port of the MongoDB server.
+                 * \param db          Database to store the frames in.
+                 * \param collection  Collection to store the frames in.
+                 * \param tag         Free-form tag stored with every frame.
+                 * \param batch_size  Maximum number of frames per bulk insert.
+                 * \param flush_ms    Maximum time a frame waits before a partial batch is written.
+                 * \param max_queued  Maximum number of frames held in memory.
+                 *
+                 * Throws std::invalid_argument if `batch_size` or `max_queued` is not positive, or if
+                 * `ip` and `port` do not form a valid MongoDB URI.
+                 */
+                static sptr make(const std::string& ip, int port, const std::string& db, const std::string& collection, const std::string& tag, int batch_size = 256, int flush_ms = 500, int max_queued = 65536);
+
+                /*!
+                 * \brief Number of frames successfully written to the database.
+                 */
+                virtual uint64_t num_inserted() const = 0;
+
+                /*!
+                 * \brief Number of frames dropped because the queue was full or all retries failed.
+                 */
+                virtual uint64_t num_dropped() const = 0;
+        };
+
+    } // namespace lora
+} // namespace gr
+
+#endif /* INCLUDED_LORA_MESSAGE_MONGODB_SINK_H */
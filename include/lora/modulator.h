@@ -0,0 +1,84 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LORA_MODULATOR_H
+#define INCLUDED_LORA_MODULATOR_H
+
+#include <lora/api.h>
+#include <lora/encoder.h>
+#include <gnuradio/sync_block.h>
+#include <vector>
+
+namespace gr {
+    namespace lora {
+        /*!
+         * \brief LoRa modulator: turns payloads into baseband frames.
+         *
+         * Payloads arrive on the `frames` message port as a blob, a u8vector
+         * or a PDU, or are queued with `queue_frame`. Each one is sent as a
+         * complete frame followed by `gap_symbols` symbols of silence; while
+         * the queue is empty the output is zero. The first sample of every
+         * frame is tagged with `payload_len`.
+         *
+         * \ingroup lora
+         */
+        class LORA_API modulator : virtual public gr::sync_block {
+            public:
+                typedef std::shared_ptr<modulator> sptr;
+
+                /*!
+                 * \brief Return a shared_ptr to a new instance of lora::modulator.
+                 *
+                 * \param samp_rate     Output sample rate, an integer multiple of `bandwidth`.
+                 * \param bandwidth     Chirp bandwidth.
+                 * \param sf            Spreading factor.
+                 * \param cr            Coding rate 4/(4+cr).
+                 * \param crc           Append the MAC CRC.
+                 * \param implicit      Leave out the explicit header.
+                 * \param reduced_rate  Low data rate optimization.
+                 * \param preamble_len  Number of preamble upchirps.
+                 * \param sync_word     Sync word.
+                 * \param gap_symbols   Silence after each frame, in symbols.
+                 */
+                static sptr make(float samp_rate, uint32_t bandwidth, uint8_t sf, uint8_t cr = 4, bool crc = true,
+                                 bool implicit = false, bool reduced_rate = false,
+                                 uint16_t preamble_len = ENCODER_DEFAULT_PREAMBLE_LEN, uint8_t sync_word = ENCODER_DEFAULT_SYNC_WORD,
+                                 uint32_t gap_symbols = 16);
+
+                /*!
+                 * \brief Queue a payload of at most 255 bytes. Safe to call from any thread.
+                 */
+                virtual void queue_frame(const std::vector<uint8_t>& payload) = 0;
+
+                /*!
+                 * \brief Number of frames waiting to be modulated.
+                 */
+                virtual uint32_t num_queued() = 0;
+
+                /*!
+                 * \brief Number of frames modulated so far.
+                 */
+                virtual uint64_t num_frames() const = 0;
+        };
+
+    } // namespace lora
+} // namespace gr
+
+#endif /* INCLUDED_LORA_MODULATOR_H */
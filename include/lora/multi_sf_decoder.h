@@ -0,0 +1,101 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LORA_MULTI_SF_DECODER_H
+#define INCLUDED_LORA_MULTI_SF_DECODER_H
+
+#include <lora/api.h>
+#include <lora/frame.h>
+#include <lora/phy_decoder.h>
+#include <gnuradio/gr_complex.h>
+#include <memory>
+#include <vector>
+
+namespace gr {
+    namespace lora {
+        /*!
+         * \brief The receive chains of several spreading factors on one channel, behind a single preamble detector.
+         *
+         * One detection pass over the input looks for the preambles of every SF at once, and hands each one to
+         * the `phy_decoder` of its SF, which synchronizes and decodes it. Without a preamble, the decoders only
+         * skip ahead, so an idle channel costs about as much as detecting the smallest SF alone, however many
+         * SFs are monitored.
+         *
+         * Frames of all SFs are returned in the order they complete, with their SF in the LoRaTap header.
+         * Like `phy_decoder`, a `multi_sf_decoder` is not thread safe, except for the counters.
+         *
+         * \ingroup lora
+         */
+        class LORA_API multi_sf_decoder {
+            public:
+                typedef std::shared_ptr<multi_sf_decoder> sptr;
+
+                /*!
+                 * \brief Return a shared_ptr to a new multi_sf_decoder. The parameters are those of
+                 *        `phy_decoder::make`, with a list of spreading factors instead of one.
+                 */
+                static sptr make(float samp_rate, uint32_t bandwidth, const std::vector<uint8_t>& sfs, bool implicit, uint8_t cr, bool crc, bool reduced_rate, bool disable_drift_correction);
+
+                virtual ~multi_sf_decoder() {}
+
+                /*!
+                 * \brief Decode a block of contiguous samples of any length. Less than `lookahead()` samples
+                 *        are kept for the next block.
+                 *
+                 * \return The frames completed during this call.
+                 */
+                virtual std::vector<frame_sptr> process(const gr_complex* samples, size_t length) = 0;
+
+                /*!
+                 * \brief Decode the kept samples as if the input went on with silence, then start over at
+                 *        position zero. Call once after the last block of a capture.
+                 *
+                 * \return The frames completed by the kept samples.
+                 */
+                virtual std::vector<frame_sptr> flush() = 0;
+
+                /*!
+                 * \brief Return every SF to preamble detection, drop any kept samples and restart positions at zero.
+                 */
+                virtual void reset() = 0;
+
+                //! Two symbols of the largest SF.
+                virtual uint32_t lookahead() const = 0;
+                //! The monitored spreading factors, in increasing order.
+                virtual std::vector<uint8_t> sfs() const = 0;
+
+                /*!
+                 * \brief The receive chain of one of the SFs, for its settings and counters. Its `process`,
+                 *        `consume`, `flush` and `reset` must not be called directly.
+                 *
+                 * \return The decoder, or a null pointer if `sf` is not monitored.
+                 */
+                virtual phy_decoder::sptr decoder(uint8_t sf) = 0;
+
+                //! Window pairs tested by the shared detector, over all SFs.
+                virtual uint64_t num_windows() = 0;
+                //! Detections of an SF ignored because a preamble of a smaller SF, which repeats at the same lag, explains them.
+                virtual uint64_t num_harmonic_rejects() = 0;
+        };
+
+    } // namespace lora
+} // namespace gr
+
+#endif /* INCLUDED_LORA_MULTI_SF_DECODER_H */
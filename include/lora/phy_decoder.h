@@ -0,0 +1,170 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LORA_PHY_DECODER_H
+#define INCLUDED_LORA_PHY_DECODER_H
+
+#include <lora/api.h>
+#include <lora/frame.h>
+#include <gnuradio/gr_complex.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gr {
+    namespace lora {
+        /*!
+         * \brief The LoRa PHY receive chain (detection, synchronization, demodulation and decoding) on plain
+         *        sample buffers, without a GNU Radio flowgraph.
+         *
+         * `lora::decoder` is a thin block around this class. Samples are taken at the same rate and with the
+         * same settings as the block. Frames are returned in the order they complete, as pooled `frame`
+         * objects carrying their LoRaTap header, timing and channel estimates. Sample positions count the
+         * samples consumed since construction or the last `reset`.
+         *
+         * A `phy_decoder` is not thread safe, except for the counters, which may be read from any thread.
+         *
+         * \ingroup lora
+         */
+        class LORA_API phy_decoder {
+            public:
+                typedef std::shared_ptr<phy_decoder> sptr;
+
+                /*!
+                 * \brief Return a shared_ptr to a new phy_decoder. The parameters are those of `decoder::make`.
+                 */
+                static sptr make(float samp_rate, uint32_t bandwidth, uint8_t sf, bool implicit, uint8_t cr, bool crc, bool reduced_rate, bool disable_drift_correction);
+
+                virtual ~phy_decoder() {}
+
+                /*!
+                 * \brief Decode a block of contiguous samples of any length. Samples that cannot be processed
+                 *        yet are kept, less than `lookahead()` of them, and prepended to the next block.
+                 *
+                 * \return The frames completed during this call.
+                 */
+                virtual std::vector<frame_sptr> process(const gr_complex* samples, size_t length) = 0;
+
+                /*!
+                 * \brief Decode from the caller's buffer without keeping any samples: runs as long as at least
+                 *        `lookahead()` samples remain, and appends completed frames to `frames`.
+                 *        <br/>Do not mix with `process` unless `pending()` is zero.
+                 *
+                 * \return The number of samples consumed. The caller passes the rest again in the next call.
+                 */
+                virtual size_t consume(const gr_complex* samples, size_t length, std::vector<frame_sptr>& frames) = 0;
+
+                /*!
+                 * \brief Decode the samples kept by `process` as if the input went on with silence, so that a frame
+                 *        ending at the very end of a capture completes. Call once after the last block.
+                 *
+                 * \return The frames completed by the kept samples.
+                 */
+                virtual std::vector<frame_sptr> flush() = 0;
+
+                /*!
+                 * \brief Return to preamble detection, drop any kept samples and restart positions at zero.
+                 */
+                virtual void reset() = 0;
+
+                //! Samples needed before a step of the state machine can run: two symbols.
+                virtual uint32_t lookahead() const = 0;
+                //! Samples kept by `process` for the next block.
+                virtual size_t pending() const = 0;
+                //! Samples consumed since construction or `reset`.
+                virtual uint64_t position() const = 0;
+                virtual uint32_t samples_per_symbol() const = 0;
+                virtual uint8_t sf() const = 0;
+
+                /*!
+                 * \brief Estimate the carrier frequency offset of each frame, stored in its channel estimates.
+                 *        Off by default; costs one extra symbol of phase computations per frame.
+                 */
+                virtual void set_estimate_cfo(bool estimate) = 0;
+
+                /*!
+                 * \brief Drop frames whose MAC CRC does not match instead of returning them. Off by default.
+                 *        Frames without a MAC CRC are always returned.
+                 */
+                virtual void set_drop_invalid(bool drop) = 0;
+
+                /*!
+                 * \brief Return only frames with one of these sync words, e.g. 0x34 (LoRaWAN public) or
+                 *        0x12 (private). Other frames are dropped right after the preamble. Empty accepts
+                 *        every sync word, which is the default.
+                 */
+                virtual void set_sync_words(const std::vector<uint8_t>& sync_words) = 0;
+
+                /*!
+                 * \brief Also decode frames with inverted IQ (LoRaWAN downlinks) from the same input, and mark
+                 *        them in their channel estimates. Off by default; costs one extra correlation per
+                 *        detected preamble.
+                 */
+                virtual void set_dual_polarity(bool dual) = 0;
+
+                /*!
+                 * \brief Find out per frame whether it has an explicit header and uses the low data rate
+                 *        optimization, instead of relying on the configuration. A frame whose header checksum
+                 *        fails is decoded without header, with the configured CR and CRC, and counted in
+                 *        `num_inferred_implicit` instead of `num_header_aborts`. It ends at the first symbol
+                 *        below the energy threshold, or before the block in which four weak symbols in a row
+                 *        started. Off by default.
+                 */
+                virtual void set_autodetect(bool autodetect) = 0;
+
+                //! Symbols worth of input samples consumed.
+                virtual uint64_t num_symbols() = 0;
+                //! Preambles detected.
+                virtual uint64_t num_detections() = 0;
+                //! Transitions from SYNC to FIND_SFD.
+                virtual uint64_t num_sfd_searches() = 0;
+                //! Returns to DETECT because the SFD was not found.
+                virtual uint64_t num_sync_aborts() = 0;
+                //! Returns to DETECT because the sync word was not accepted.
+                virtual uint64_t num_sync_word_aborts() = 0;
+                //! Explicit headers decoded.
+                virtual uint64_t num_headers() = 0;
+                //! Returns to DETECT because the explicit header checksum did not match.
+                virtual uint64_t num_header_aborts() = 0;
+                //! Frames decoded without header by `set_autodetect`, because their header did not check out.
+                virtual uint64_t num_inferred_implicit() = 0;
+                //! Payloads decoded.
+                virtual uint64_t num_payloads() = 0;
+                //! Payloads whose MAC CRC did not match, returned or not.
+                virtual uint64_t num_crc_errors() = 0;
+                //! Returns to DETECT because the payload symbols faded into noise or lost their shape.
+                virtual uint64_t num_payload_aborts() = 0;
+                //! Frames dropped after their SFD because every packet context was busy with another frame.
+                virtual uint64_t num_context_aborts() = 0;
+                //! Ticks spent per state, keyed by state name (e.g. "DETECT").
+                virtual std::map<std::string, uint64_t> state_ticks() = 0;
+                //! Steps of the state machine per state, keyed by state name.
+                virtual std::map<std::string, uint64_t> state_visits() = 0;
+                //! Steps in the given state; element i counts steps of 2^i to 2^(i+1) ticks.
+                virtual std::vector<uint64_t> state_histogram(const std::string& state) = 0;
+                //! Zero all counters. Safe to call from any thread; takes effect at the next step.
+                virtual void reset_counters() = 0;
+        };
+
+    } // namespace lora
+} // namespace gr
+
+#endif /* INCLUDED_LORA_PHY_DECODER_H */
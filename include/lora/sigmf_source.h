@@ -0,0 +1,96 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LORA_SIGMF_SOURCE_H
+#define INCLUDED_LORA_SIGMF_SOURCE_H
+
+#include <lora/api.h>
+#include <gnuradio/sync_block.h>
+#include <string>
+
+namespace gr {
+    namespace lora {
+        /*!
+         * \brief Replays a SigMF recording or a raw IQ file straight from a memory mapping.
+         *
+         * `path` may name the `.sigmf-meta` or `.sigmf-data` file of a recording,
+         * their common base name, or a raw file without metadata. The sample
+         * format is `cf32`, `ci16` or `ci8` (little-endian, optionally with the
+         * SigMF `_le` suffix); it is read from `core:datatype` unless `format`
+         * is given, and defaults to `cf32` for raw files. Integer samples are
+         * scaled to [-1, 1).
+         *
+         * The first sample of every SigMF annotation is tagged with
+         * `annotation`, holding its `core:label` (or an empty string), and the
+         * output can be moved to any sample or annotation at runtime. At the
+         * end of the file the block finishes, or starts over if `repeat` is set.
+         *
+         * \ingroup lora
+         */
+        class LORA_API sigmf_source : virtual public gr::sync_block {
+            public:
+                typedef std::shared_ptr<sigmf_source> sptr;
+
+                /*!
+                 * \brief Return a shared_ptr to a new instance of lora::sigmf_source.
+                 *
+                 * \param path      Recording or raw file to read.
+                 * \param format    Sample format, overriding the metadata.
+                 * \param repeat    Start over at the end of the file.
+                 */
+                static sptr make(const std::string& path, const std::string& format = "", bool repeat = false);
+
+                /*!
+                 * \brief Number of samples in the file.
+                 */
+                virtual uint64_t length() const = 0;
+
+                /*!
+                 * \brief `core:sample_rate` of the recording, or 0 if unknown.
+                 */
+                virtual double sample_rate() const = 0;
+
+                /*!
+                 * \brief `core:frequency` of the first capture, or 0 if unknown.
+                 */
+                virtual double frequency() const = 0;
+
+                /*!
+                 * \brief Continue the output at the given sample. Safe to call from any thread.
+                 *
+                 * \return Whether the sample lies within the file.
+                 */
+                virtual bool seek(uint64_t sample) = 0;
+
+                virtual uint32_t    num_annotations() const = 0;
+                virtual uint64_t    annotation_start(uint32_t index) const = 0;
+                virtual uint64_t    annotation_length(uint32_t index) const = 0;
+                virtual std::string annotation_label(uint32_t index) const = 0;
+
+                /*!
+                 * \brief Continue the output at the first sample of an annotation, in file order.
+                 */
+                virtual bool seek_annotation(uint32_t index) = 0;
+        };
+
+    } // namespace lora
+} // namespace gr
+
+#endif /* INCLUDED_LORA_SIGMF_SOURCE_H */
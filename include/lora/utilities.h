@@ -102,6 +102,20 @@ namespace gr {
             return ((bits << count) & len_mask) | (bits >> (size - count));
         }
 
+        /**
+         *  \brief  Rotate the given bits to the right and return the result. Inverse of `rotl`.
+         *
+         *  \param  bits
+         *          The value to rotate.
+         *  \param  count
+         *          The amount of bits to rotate (shift to right and add to left).
+         *  \param  size
+         *          The size in bits used in `bits`.
+         */
+        inline uint32_t rotr(uint32_t bits, uint32_t count = 1u, const uint32_t size = 8u) {
+            return rotl(bits, size - count % size, size);
+        }
+
         /**
          *  \brief  Return the `v` represented in a binary string.
          *
@@ -393,14 +407,131 @@ namespace gr {
             out << std::flush;
         }
 
+        /**
+         *  \brief  Compute the 5-bit checksum of an explicit PHY header, as sent in the lowest bit of `crc_msn`
+         *          (bit 4) and in `reserved` (bits 3..0).
+         *
+         *  \param  length
+         *          The payload length in the header.
+         *  \param  cr
+         *          The coding rate in the header.
+         *  \param  has_mac_crc
+         *          The CRC flag in the header.
+         */
+        inline uint8_t header_checksum_value(const uint8_t length, const uint8_t cr, const bool has_mac_crc) {
+            static const uint8_t indices[5][6] = {
+                { 1, 4, 8, 9, 10, 11 },
+                { 0, 2, 5, 8, 9, 10 },
+                { 0, 3, 6, 9, 11 },
+                { 1, 2, 3, 7, 8 },
+                { 4, 5, 6, 7 }
+            };
+            static const uint8_t counts[5] = { 6, 6, 5, 5, 4 };
+            const uint32_t w = length | ((uint32_t)((cr << 1u) | has_mac_crc) << 8u);
+            uint8_t checksum = 0u;
+
+            for (uint8_t i = 0u; i < 5u; i++) {
+                uint8_t b = 0u;
+                for (uint8_t j = 0u; j < counts[i]; j++)
+                    b ^= (w >> indices[i][j]) & 1u;
+
+                checksum |= b << i;
+            }
+
+            return checksum;
+        }
+
+        /**
+         *  \brief  Check the 5-bit checksum of a decoded explicit PHY header.
+         *
+         *  \param  header
+         *          The three header bytes, laid out as `loraphy_header_t`.
+         */
         inline bool header_checksum(const uint8_t* header) {
-            (void) header;
-            /*Found valid order for bit #0: (1, 4, 8, 9, 10, 11)
-            Found valid order for bit #1: (0, 2, 5, 8, 9, 10)
-            Found valid order for bit #2: (0, 3, 6, 9, 11)
-            Found valid order for bit #3: (1, 2, 3, 7, 8)
-            Found valid order for bit #4: (4, 5, 6, 7)*/
-            return true;
+            const uint8_t checksum = (uint8_t)(((header[1] & 0x01u) << 4u) | (header[2] >> 4u));
+
+            return checksum == header_checksum_value(header[0], header[1] >> 5u, (header[1] >> 4u) & 0x01u);
+        }
+
+        /**
+         *  \brief  Stricter than `header_checksum`, for telling explicit headers from payload: a random block passes
+         *          the 5-bit checksum once in 32, but then also has to leave the three bits next to the checksum zero
+         *          and have a coding rate between 1 and 4.
+         *
+         *  \param  header
+         *          The three header bytes, laid out as `loraphy_header_t`.
+         */
+        inline bool header_plausible(const uint8_t* header) {
+            const uint8_t cr = header[1] >> 5u;
+
+            return (header[1] & 0x0eu) == 0u && cr >= 1u && cr <= 4u && header_checksum(header);
+        }
+
+        /**
+         *  \brief  Lookup tables for `crc16`: `t[k][b]` is the CRC of byte `b` followed by `k` zero bytes.
+         */
+        struct crc16_slices {
+            uint16_t t[8][256];
+
+            crc16_slices() {
+                for (uint32_t b = 0u; b < 256u; b++) {
+                    uint16_t crc = (uint16_t)(b << 8u);
+
+                    for (uint8_t i = 0u; i < 8u; i++)
+                        crc = (crc & 0x8000) ? (uint16_t)((crc << 1u) ^ 0x1021) : (uint16_t)(crc << 1u);
+
+                    t[0][b] = crc;
+                }
+
+                for (uint32_t k = 1u; k < 8u; k++) {
+                    for (uint32_t b = 0u; b < 256u; b++)
+                        t[k][b] = (uint16_t)(t[k - 1u][b] << 8u) ^ t[0][t[k - 1u][b] >> 8u];
+                }
+            }
+        };
+
+        /**
+         *  \brief  CRC-16/XMODEM (polynomial 0x1021, MSB first, no final XOR), computed eight bytes at a time
+         *          (slice-by-8).
+         *
+         *  \param  data
+         *          The bytes to checksum.
+         *  \param  length
+         *          The amount of bytes.
+         *  \param  crc
+         *          The initial value.
+         */
+        inline uint16_t crc16(const uint8_t* data, const uint32_t length, uint16_t crc = 0x0000) {
+            static const crc16_slices s;
+            uint32_t i = 0u;
+
+            // The running CRC enters through the first two bytes of each block
+            for (; i + 8u <= length; i += 8u) {
+                crc = s.t[7][data[i]      ^ (crc >> 8u)]   ^ s.t[6][data[i + 1u] ^ (crc & 0xffu)]
+                    ^ s.t[5][data[i + 2u]] ^ s.t[4][data[i + 3u]] ^ s.t[3][data[i + 4u]]
+                    ^ s.t[2][data[i + 5u]] ^ s.t[1][data[i + 6u]] ^ s.t[0][data[i + 7u]];
+            }
+
+            for (; i < length; i++)
+                crc = (uint16_t)(crc << 8u) ^ s.t[0][(crc >> 8u) ^ data[i]];
+
+            return crc;
+        }
+
+        /**
+         *  \brief  Compute the MAC CRC of a payload the way a LoRa transmitter does: CRC-16 over all but the
+         *          last two bytes, XORed with those two bytes. It is sent little-endian after the payload.
+         *
+         *  \param  payload
+         *          The payload, without CRC.
+         *  \param  length
+         *          The length of the payload.
+         */
+        inline uint16_t payload_crc(const uint8_t* payload, const uint32_t length) {
+            if (length < 2u)
+                return length ? payload[0] : 0u;
+
+            return crc16(payload, length - 2u) ^ payload[length - 1u] ^ ((uint16_t)payload[length - 2u] << 8u);
         }
 
         inline uint32_t dissect_packet(const void **header, uint32_t header_size, const uint8_t *buffer, uint32_t offset) {
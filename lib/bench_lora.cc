@@ -0,0 +1,263 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Kernel benchmark for the decoder. Times each primitive on ideal chirps for every combination of spreading
+ * factor and sample rate, and prints one JSON object per measurement:
+ *
+ *     bench_lora [--sf 7,8,...] [--samp-rate 125000,1000000,...] [--bandwidth 125000] [--min-time 0.2] [--output file.json]
+ */
+
+#ifdef HAVE_CONFIG_H
+    #include "config.h"
+#endif
+
+#include "phy_decoder_impl.h"
+#include <lora/utilities.h>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_PAYLOAD_LENGTH 16u    ///< Payload bytes used for `decode` and `build_frame`, without MAC CRC.
+
+namespace gr {
+    namespace lora {
+
+        typedef struct bench_result {
+            std::string primitive;
+            uint64_t    iterations;
+            double      ns_per_call;
+            double      symbols_per_call;
+        } bench_result_t;
+
+        /**
+         *  \brief  Drives the private kernels of a `phy_decoder_impl` directly.
+         */
+        class decoder_bench {
+            private:
+                phy_decoder_impl*           d_dec;
+                const double            d_min_time;
+                std::vector<gr_complex> d_samples;      ///< Three symbols of ideal upchirps, shifted by a nonzero symbol value.
+                std::vector<float>      d_ifreq;
+                std::vector<uint32_t>   d_words;        ///< One interleaved block of `4 + cr` symbols.
+                std::vector<uint8_t>    d_demodulated;  ///< Deinterleaved codewords of one payload.
+                std::vector<uint8_t>    d_payload;
+                volatile uint64_t       d_sink;         ///< Keeps results alive so that calls are not optimized away.
+
+                /**
+                 *  Repeat `f` until `d_min_time` seconds have elapsed, after a short warm-up.
+                 */
+                bench_result_t time(const std::string& primitive, double symbols_per_call, const std::function<void()>& f) {
+                    typedef std::chrono::steady_clock clock;
+
+                    for (uint32_t i = 0u; i < 16u; i++)
+                        f();
+
+                    uint64_t iterations = 0u;
+                    uint64_t batch      = 16u;
+                    double   elapsed    = 0.0;
+                    const clock::time_point start = clock::now();
+
+                    while (elapsed < d_min_time) {
+                        for (uint64_t i = 0u; i < batch; i++)
+                            f();
+
+                        iterations += batch;
+                        batch      *= 2u;
+                        elapsed     = std::chrono::duration<double>(clock::now() - start).count();
+                    }
+
+                    return { primitive, iterations, elapsed * 1e9 / iterations, symbols_per_call };
+                }
+
+            public:
+                decoder_bench(phy_decoder_impl* dec, double min_time) : d_dec(dec), d_min_time(min_time), d_sink(0u) {
+                    const uint32_t sps   = d_dec->d_samples_per_symbol;
+                    const uint32_t shift = (d_dec->d_number_of_bins / 3u) * d_dec->d_decim_factor;
+
+                    d_samples.resize(3u * sps);
+                    for (uint32_t i = 0u; i < d_samples.size(); i++)
+                        d_samples[i] = d_dec->d_upchirp[(i + shift) % sps];
+                    d_ifreq.resize(2u * sps);
+
+                    for (uint32_t i = 0u; i < 4u + d_dec->d_ctx->phdr.cr; i++)
+                        d_words.push_back((i * 37u + 11u) & ((1u << d_dec->d_sf) - 1u));
+
+                    d_payload.resize(BENCH_PAYLOAD_LENGTH + MAC_CRC_SIZE);
+                    for (uint32_t i = 0u; i < d_payload.size(); i++)
+                        d_payload[i] = (uint8_t)(i * 29u + 3u);
+
+                    // Two codewords per byte at CR 4/8
+                    d_demodulated.resize(2u * d_payload.size());
+                    for (uint32_t i = 0u; i < d_demodulated.size(); i++)
+                        d_demodulated[i] = (uint8_t)(i * 53u + 7u);
+                }
+
+                std::vector<bench_result_t> run() {
+                    phy_decoder_impl* dec = d_dec;
+                    const uint32_t sps   = dec->d_samples_per_symbol;
+                    const uint32_t block = 4u + dec->d_ctx->phdr.cr;
+                    const double payload_symbols = (double)d_demodulated.size() * block / dec->d_sf;  // One block of `4 + cr` symbols carries `sf` codewords
+                    std::vector<bench_result_t> results;
+
+                    results.push_back(time("instantaneous_frequency", 1.0, [&] {
+                        dec->instantaneous_frequency(&d_samples[0], &d_ifreq[0], sps);
+                        d_sink = d_sink + (uint64_t)d_ifreq[sps / 2u];
+                    }));
+
+                    dec->instantaneous_frequency(&d_samples[0], &d_ifreq[0], 2u * sps);
+                    results.push_back(time("sliding_norm_cross_correlate_upchirp", 1.0, [&] {
+                        int32_t index = 0;
+                        dec->sliding_norm_cross_correlate_upchirp(&d_ifreq[0], sps, &index);
+                        d_sink = d_sink + index;
+                    }));
+
+                    results.push_back(time("cross_correlate_ifreq", 1.0, [&] {
+                        d_sink = d_sink + (int64_t)(1e3f * dec->cross_correlate_ifreq(&d_ifreq[0], dec->d_downchirp_ifreq, sps - 1u));
+                    }));
+
+                    results.push_back(time("cross_correlate_ifreq_centered", 1.0, [&] {
+                        d_sink = d_sink + (int64_t)(1e3f * dec->cross_correlate_ifreq_centered(&d_ifreq[0], &dec->d_downchirp_ifreq_centered[0],
+                                                                                                  dec->d_downchirp_ifreq_energy, sps - 1u));
+                    }));
+
+                    results.push_back(time("fine_sync", 1.0, [&] {
+                        dec->fine_sync(&d_samples[0], dec->d_number_of_bins / 3u, std::max(dec->d_decim_factor / 4u, 2u));
+                        d_sink = d_sink + dec->d_ctx->fine_sync;
+                    }));
+
+                    // Same symbol as `fine_sync`, from its instantaneous frequency as computed by `demodulate`
+                    results.push_back(time("track_timing", 1.0, [&] {
+                        dec->track_timing(&d_ifreq[0], dec->d_number_of_bins / 3u, std::max(dec->d_decim_factor / 4u, 2u));
+                        d_sink = d_sink + dec->d_ctx->fine_sync;
+                    }));
+
+                    results.push_back(time("max_frequency_gradient_idx", 1.0, [&] {
+                        d_sink = d_sink + dec->max_frequency_gradient_idx(&d_samples[0]);
+                    }));
+
+                    results.push_back(time("get_shift_fft", 1.0, [&] {
+                        d_sink = d_sink + dec->get_shift_fft(&d_samples[0]);
+                    }));
+
+                    results.push_back(time("deinterleave", block, [&] {
+                        dec->d_ctx->words.assign(d_words.begin(), d_words.end());
+                        dec->deinterleave(dec->d_sf);
+                        d_sink = d_sink + dec->d_ctx->demodulated.back();
+                        dec->d_ctx->demodulated.clear();
+                    }));
+
+                    results.push_back(time("decode", payload_symbols, [&] {
+                        dec->d_ctx->demodulated.assign(d_demodulated.begin(), d_demodulated.end());
+                        dec->decode(false);
+                        d_sink = d_sink + dec->d_ctx->decoded.back();
+                        dec->d_ctx->decoded.clear();
+                    }));
+
+                    dec->d_ctx->phdr.length = BENCH_PAYLOAD_LENGTH;
+                    dec->d_ctx->payload_length = d_payload.size();
+                    dec->d_ctx->decoded.assign(d_payload.begin(), d_payload.end());
+                    dec->d_ctx->snr = 10.0f;
+                    results.push_back(time("build_frame", payload_symbols, [&] {
+                        d_sink = d_sink + dec->build_frame()->size();
+                    }));
+                    dec->d_ctx->decoded.clear();
+
+                    return results;
+                }
+        };
+    }
+}
+
+static std::vector<double> parse_list(const char* arg) {
+    std::vector<double> values;
+    std::stringstream ss(arg);
+    std::string item;
+
+    while (std::getline(ss, item, ','))
+        values.push_back(atof(item.c_str()));
+
+    return values;
+}
+
+int main(int argc, char** argv) {
+    std::vector<double> sfs        = { 7, 8, 9, 10, 11, 12 };
+    std::vector<double> samp_rates = { 125000, 1000000 };
+    double bandwidth = 125000;
+    double min_time  = 0.2;
+    std::string output;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--sf"))
+            sfs = parse_list(argv[i + 1]);
+        else if (!strcmp(argv[i], "--samp-rate"))
+            samp_rates = parse_list(argv[i + 1]);
+        else if (!strcmp(argv[i], "--bandwidth"))
+            bandwidth = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--min-time"))
+            min_time = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--output"))
+            output = argv[i + 1];
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--sf 7,8,...] [--samp-rate 125000,...] [--bandwidth 125000] [--min-time 0.2] [--output file.json]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::ofstream file;
+    if (!output.empty())
+        file.open(output.c_str(), std::ios::out);
+    std::ostream& out = output.empty() ? std::cout : file;
+
+    out << "[" << std::endl;
+    bool first = true;
+
+    for (double sf : sfs) {
+        for (double samp_rate : samp_rates) {
+            gr::lora::phy_decoder_impl dec(samp_rate, bandwidth, (uint8_t)sf, false, 4, true, false, false);
+
+            gr::lora::decoder_bench bench(&dec, min_time);
+            const uint32_t sps = (uint32_t)(samp_rate / bandwidth) << (uint32_t)sf;
+
+            for (const gr::lora::bench_result_t& r : bench.run()) {
+                const double ns_per_symbol = r.ns_per_call / r.symbols_per_call;
+
+                out << (first ? "  " : ",\n  ")
+                    << "{\"primitive\": \"" << r.primitive << "\""
+                    << ", \"sf\": "                 << (int)sf
+                    << ", \"samp_rate\": "          << samp_rate
+                    << ", \"bandwidth\": "          << bandwidth
+                    << ", \"iterations\": "         << r.iterations
+                    << ", \"ns_per_call\": "        << r.ns_per_call
+                    << ", \"ns_per_symbol\": "      << ns_per_symbol
+                    << ", \"samples_per_second\": " << sps * 1e9 / ns_per_symbol
+                    << "}";
+                first = false;
+            }
+        }
+    }
+
+    out << std::endl << "]" << std::endl;
+    return 0;
+}
@@ -5,20 +5,41 @@
 #include <unistd.h>
 #include <string.h>
 #include <netinet/in.h>
+#include <algorithm>
 
 namespace gr {
     namespace lora {
-        debugger::debugger() : d_attached(false) {
+        debugger::debugger(uint32_t num_snapshots, uint32_t max_samples)
+            : d_max_samples(std::max(max_samples, 1u)),
+              d_ring(std::max(num_snapshots, 1u)),
+              d_ring_head(0u),
+              d_ring_count(0u),
+              d_running(false),
+              d_sent(0u),
+              d_dropped(0u),
+              d_truncated(0u),
+              d_socket(-1),
+              d_attached(false) {
+            // Buffers are only allocated while attached, as most decoders never are
+            d_staging.length = 0u;
+            d_sending.length = 0u;
+            for (snapshot& s : d_ring)
+                s.length = 0u;
         }
 
         debugger::~debugger() {
-
+            detach();
         }
 
         /*
-         * Attach to a UNIX domain socket.
+         * Attach to a UNIX domain socket and start the sender thread. All buffers are allocated here,
+         * so that the tap never allocates while decoding.
          */
         void debugger::attach(std::string path) {
+            if(d_attached)
+                return;
+            detach();   // Reap a sender that stopped after the analyzer went away
+
             if((d_socket = socket(AF_UNIX, SOCK_STREAM, 0)) == -1) {
                 std::cerr << "Failed to create UNIX domain socket." << std::endl;
                 return;
@@ -31,16 +52,50 @@ namespace gr {
 
             if(connect(d_socket, (struct sockaddr*)&address, sizeof(address)) == -1) {
                 //std::cerr << "Failed to connect to analyzer." << std::endl;
-            } else {
-                d_attached = true;
+                close(d_socket);
+                d_socket = -1;
+                return;
             }
+
+            d_staging.samples.resize(d_max_samples);
+            d_sending.samples.resize(d_max_samples);
+            for (snapshot& s : d_ring)
+                s.samples.resize(d_max_samples);
+
+            d_running  = true;
+            d_attached = true;
+            d_thread   = std::shared_ptr<boost::thread>(new boost::thread(boost::bind(&debugger::send_samples, this)));
         }
 
         void debugger::detach(void) {
-            if(d_attached) {
+            {
+                boost::mutex::scoped_lock lock(d_mutex);
+                d_running = false;
+            }
+            d_cond.notify_one();
+
+            // Wakes the sender if it is blocked in send(), which then fails
+            if(d_socket != -1)
+                shutdown(d_socket, SHUT_RDWR);
+
+            if(d_thread) {
+                d_thread->join();
+                d_thread.reset();
+            }
+
+            if(d_socket != -1) {
                 close(d_socket);
-                d_attached = false;
+                d_socket = -1;
             }
+
+            d_attached   = false;
+            d_ring_count = 0u;
+            d_staging.length = 0u;
+
+            std::vector<gr_complex>().swap(d_staging.samples);
+            std::vector<gr_complex>().swap(d_sending.samples);
+            for (snapshot& s : d_ring)
+                std::vector<gr_complex>().swap(s.samples);
         }
 
         /*
@@ -48,35 +103,105 @@ namespace gr {
 
         See: https://github.com/gnuradio/gnuradio/search?utf8=%E2%9C%93&q=quicksort_index.h&type=
         */
+        /**
+         *  Queue a copy of the stored samples for the analyzer. If all snapshots are still pending,
+         *  the oldest one is overwritten and counted as dropped.
+         */
         void debugger::analyze_samples(bool clear, bool draw_over) {
             if(d_attached) {
-                uint32_t num_payload_bytes = d_samples.size() * sizeof(gr_complex);
-                int32_t num_bytes_sent;
+                {
+                    boost::mutex::scoped_lock lock(d_mutex);
+                    uint32_t slot;
 
-                debugger::header hdr;
-                hdr.length = htonl(num_payload_bytes);
-                hdr.draw_over = draw_over;
+                    if(d_ring_count == d_ring.size()) {
+                        slot = d_ring_head;
+                        d_ring_head = (d_ring_head + 1u) % d_ring.size();
+                        d_dropped++;
+                    } else {
+                        slot = (d_ring_head + d_ring_count) % d_ring.size();
+                        d_ring_count++;
+                    }
 
-                // Send header
-                if((num_bytes_sent = send(d_socket, &hdr, sizeof(hdr), 0)) == -1) {
-                    std::cerr << "Failed to send header." << std::endl;
-                    return;
-                }
-
-                // Send payload
-                if((num_bytes_sent = send(d_socket, &d_samples[0], num_payload_bytes, 0)) == -1) {
-                    std::cerr << "Failed to send payload." << std::endl;
-                    return;
+                    snapshot& s = d_ring[slot];
+                    std::copy(d_staging.samples.begin(), d_staging.samples.begin() + d_staging.length, s.samples.begin());
+                    s.length    = d_staging.length;
+                    s.draw_over = draw_over;
                 }
+                d_cond.notify_one();
 
                 if(clear)
-                    d_samples.clear();
+                    d_staging.length = 0u;
             }
         }
 
         void debugger::store_samples(const gr_complex* samples, uint32_t length) {
             if(d_attached) {
-                d_samples.insert(d_samples.end(), samples, samples + length);
+                const uint32_t n = std::min(length, d_max_samples - d_staging.length);
+
+                std::copy(samples, samples + n, d_staging.samples.begin() + d_staging.length);
+                d_staging.length += n;
+                d_truncated      += length - n;
+            }
+        }
+
+        uint64_t debugger::num_sent() const {
+            return d_sent;
+        }
+
+        uint64_t debugger::num_dropped() const {
+            return d_dropped;
+        }
+
+        uint64_t debugger::num_truncated() const {
+            return d_truncated;
+        }
+
+        bool debugger::send_all(const void* data, size_t length) {
+            const uint8_t* p = (const uint8_t*)data;
+
+            while(length > 0) {
+                ssize_t num_bytes_sent = send(d_socket, p, length, MSG_NOSIGNAL);
+                if(num_bytes_sent == -1)
+                    return false;
+
+                p      += num_bytes_sent;
+                length -= num_bytes_sent;
+            }
+
+            return true;
+        }
+
+        /*
+         * Sender thread: take the oldest pending snapshot and write it to the socket. Slots are swapped
+         * rather than copied, so the ring stays preallocated.
+         */
+        void debugger::send_samples() {
+            while(true) {
+                {
+                    boost::mutex::scoped_lock lock(d_mutex);
+                    d_cond.wait(lock, [this] { return !d_running || d_ring_count > 0u; });
+
+                    if(!d_running)
+                        return;
+
+                    std::swap(d_sending, d_ring[d_ring_head]);
+                    d_ring_head = (d_ring_head + 1u) % d_ring.size();
+                    d_ring_count--;
+                }
+
+                uint32_t num_payload_bytes = d_sending.length * sizeof(gr_complex);
+
+                debugger::header hdr;
+                hdr.length = htonl(num_payload_bytes);
+                hdr.draw_over = d_sending.draw_over;
+
+                if(!send_all(&hdr, sizeof(hdr)) || !send_all(&d_sending.samples[0], num_payload_bytes)) {
+                    std::cerr << "Analyzer disconnected, stopping debug tap." << std::endl;
+                    d_attached = false;
+                    return;
+                }
+
+                d_sent++;
             }
         }
     }
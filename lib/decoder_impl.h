@@ -21,390 +21,93 @@
 #ifndef INCLUDED_LORA_DECODER_IMPL_H
 #define INCLUDED_LORA_DECODER_IMPL_H
 
-#include <liquid/liquid.h>
 #include "lora/decoder.h"
+#include "phy_decoder_impl.h"
+#include <map>
 #include <string>
 #include <vector>
-#include <fstream>
-#include <lora/debugger.h>
-#include <volk/volk.h>
-#include <lora/loraphy.h>
-#include <boost/circular_buffer.hpp>
+#include <lora/frame.h>
+#include <boost/thread.hpp>
+#include <chrono>
+#include <deque>
+#include <time.h>
+
+#define DECODER_STATS_INTERVAL  1.0   ///< Default seconds between two messages on the `stats` port.
 
 namespace gr {
     namespace lora {
 
         /**
-         *  \brief  **DecoderState** : Each state the LoRa decoder can be in.
-         */
-        enum class DecoderState {
-            DETECT,
-            SYNC,
-            FIND_SFD,
-            PAUSE,
-            DECODE_HEADER,
-            DECODE_PAYLOAD,
-            STOP
-        };
-
-        /**
-         *  \brief  Return the DecoderState as string for debugging purposes.
-         *
-         *  \param  s
-         *          The state to return to string.
+         *  \brief  A decoded payload waiting to be written to the byte stream output, with the values for its tags.
          */
-        /*static std::string state_to_string(DecoderState s) {
-            static std::string DecoderStateLUT[] = { "DETECT", "SYNC", "FIND_SFD", "PAUSE", "DECODE_HEADER", "DECODE_PAYLOAD", "STOP" };
-            return DecoderStateLUT[ (size_t)s ];
-        }*/
+        typedef struct stream_packet {
+            uint32_t length;                                ///< Number of payload bytes.
+            uint32_t written;                               ///< Number of bytes already written to the output.
+            float    snr;                                   ///< SNR in dB.
+            float    cfo;                                   ///< Coarse CFO estimate in Hz.
+            uint64_t sample_offset;                         ///< Absolute index of the input sample where the frame was synchronized.
+            bool     inverted_iq;                           ///< Received with inverted IQ.
+        } stream_packet_t;
 
         /**
          *  \brief  **LoRa Decoder**
-         *          <br/>The main class for the LoRa decoder.
-         *          Contains all variables and methods necessary for succesfully decoding LoRa PHY.
-         *          <br/>Only the sample rate and spreading factor are needed.
-         *          The other settings, like packet length and coding rate, are extracted from the (explicit) HDR.
+         *          <br/>GNU Radio block around `phy_decoder_impl`, which does all of the decoding.
+         *          Publishes its frames and statistics and writes the payloads to the byte stream output.
          */
         class decoder_impl : public decoder {
             private:
-                debugger                d_dbg;              ///< Debugger for plotting samples, printing output, etc.
-                DecoderState            d_state;            ///< Holds the current state of the decoder (state machine).
-
-                std::vector<gr_complex> d_downchirp;        ///< The complex ideal downchirp.
-                std::vector<float>      d_downchirp_ifreq;  ///< The instantaneous frequency of the ideal downchirp.
-
-                std::vector<gr_complex> d_upchirp;          ///< The complex ideal upchirp.
-                std::vector<float>      d_upchirp_ifreq;    ///< The instantaneous frequency of the ideal upchirp.
-                std::vector<float>      d_upchirp_ifreq_v;  ///< The instantaneous frequency of the ideal upchirp.
-
-                std::vector<gr_complex> d_fft;              ///< Vector containing the FFT resuls.
-                std::vector<gr_complex> d_mult_hf;          ///< Vector containing the FFT decimation.
-                std::vector<gr_complex> d_tmp;              ///< Vector containing the FFT decimation.
-
-                bool             d_implicit;                ///< Implicit header mode.
-                bool             d_reduced_rate;            ///< Use reduced rate (only configurable in implicit header mode).
-                uint8_t          d_sf;                      ///< The Spreading Factor.
-                uint32_t         d_bw;                      ///< The receiver bandwidth (fixed to `125kHz`).
-                loraphy_header_t d_phdr;                    ///< LoRa PHY header.
-                uint16_t         d_mac_crc;                 ///< The MAC CRC.
-                double           d_bits_per_second;         ///< Indicator of how many bits are transferred each second.
-                uint32_t         d_delay_after_sync;        ///< The number of samples to skip in `DecoderState::PAUSE`.
-                uint32_t         d_samples_per_second;      ///< The number of samples taken per second by GNU Radio.
-                double           d_symbols_per_second;      ///< Indicator of how many symbols (read: chirps) are transferred each second.
-                double           d_bits_per_symbol;         ///< The number of bits each of the symbols contain.
-                uint32_t         d_samples_per_symbol;      ///< The number of samples in one symbol.
-                double           d_period;                  ///< Period of the symbol.
-                uint32_t         d_number_of_bins;          ///< Indicates in how many parts or bins a symbol is decimated, i.e. the max value to decode out of one payload symbol.
-                uint32_t         d_number_of_bins_hdr;      ///< Indicates in how many parts or bins a HDR symbol is decimated, i.e. the max value to decode out of one HDR symbol.
-                 int32_t         d_payload_symbols;         ///< The number of symbols needed to decode the payload. Calculated from an indicator in the HDR.
-                uint32_t         d_payload_length;          ///< The number of words after decoding the HDR or payload. Calculated from an indicator in the HDR.
-                uint32_t         d_corr_fails;              ///< Indicates how many times the correlation failed. After some tries, the state will revert to `DecoderState::DETECT`.
-                float            d_energy_threshold;        ///< The absolute threshold to distinguish signal from noise.
-                float            d_snr;                     ///< Signal to noise ratio
-                boost::circular_buffer<float> d_pwr_queue;  ///< Queue holding symbol power values
-
-                std::vector<uint32_t> d_words;              ///< Vector containing the demodulated words.
-                std::vector<uint8_t>  d_demodulated;        ///< Vector containing the words after deinterleaving.
-                std::vector<uint8_t>  d_words_deshuffled;   ///< Vector containing the words after deshuffling.
-                std::vector<uint8_t>  d_words_dewhitened;   ///< Vector containing the words after dewhitening.
-                std::vector<uint8_t>  d_decoded;            ///< Vector containing the words after Hamming decode or the final decoded words.
-
-                std::ofstream d_debug_samples;              ///< Debug utputstream for complex values.
-                std::ofstream d_debug;                      ///< Outputstream for the debug log.
-
-                fftplan d_q;                                ///< The LiquidDSP::FFT_Plan.
-                fftplan d_qr;                               ///< The LiquidDSP::FFT_Plan in reverse.
-                fec     d_h48_fec;                          ///< LiquidDSP Hamming 4/8 FEC.
-
-                uint32_t      d_decim_factor;               ///< The number of samples (data points) in each bin.
-                float         d_cfo_estimation;             ///< An estimation for the current Center Frequency Offset.
-                double        d_dt;                         ///< Indicates how fast the frequency changes in a symbol (chirp).
-                bool    d_enable_fine_sync;                 ///< Enable drift correction
-                int32_t d_fine_sync;                        ///< Amount of drift correction to apply for next symbol
-
-                /**
-                 *  \brief  TODO
-                 */
-                float cross_correlate_ifreq_fast(const float *samples_ifreq, const float *ideal_chirp, const uint32_t window);
-
-                /**
-                 *  \brief  TODO
-                 */
-                float cross_correlate_fast(const gr_complex* samples, const gr_complex* ideal_chirp, const uint32_t window);
-
-                /**
-                 *  \brief  TODO
-                 */
-                void fine_sync(const gr_complex* in_samples, int32_t bin_idx, int32_t search_space);
-
-                /**
-                 * \brief Schmidl-Cox autocorrelation approach for approximately detecting the preamble.
-                 */
-                float detect_preamble_autocorr(const gr_complex *samples, uint32_t window);
-
-                /**
-                 *  \brief  TODO
-                 */
-                float experimental_determine_cfo(const gr_complex *samples, uint32_t window);
-
-                /**
-                 *  \brief  Generate the ideal up- and downchirps.
-                 */
-                void build_ideal_chirps(void);
-
-                /**
-                 *  \brief  Debug method to dump the given complex array to the given file in binary format.
-                 *
-                 *  \param  path
-                 *          The path to the file to dump to.
-                 *  \param  v
-                 *          The complex array to dump.
-                 *  \param  length
-                 *          Length of said array.
-                 *  \param  elem_size
-                 *          `sizeof` the data in the array.
-                 */
-                void samples_to_file(const std::string path, const gr_complex *v, const uint32_t length, const uint32_t elem_size);
-
-                /**
-                  *  \brief  Debug method to dump the given values array to a file in textual format.
-                  *
-                  *  \param  path
-                  *          The path to the file to dump to.
-                  *  \param  v
-                  *          The values array to dump.
-                  *  \param  length
-                  *          Length of said array.
-                  *  \param  ppm
-                  *          PPM value of the data.
-                  */
-                void values_to_file(const std::string path, const unsigned char *v, const uint32_t length, const uint32_t ppm);
-
-                /**
-                 *  \brief  Write the given complex array to the debug outputstream.
-                 *
-                 *  \param  v
-                 *          The complex array.
-                 *  \param  length
-                 *          Length of said complex array.
-                 */
-                void samples_debug(const gr_complex *v, const uint32_t length);
-
-                /**
-                 *  \brief  Correct the shift of the given symbol to match the ideal upchirp by sliding cross correlating.
-                 *
-                 *  \param  samples_ifreq
-                 *          The symbol to shift.
-                 *  \param  window
-                 *          The window in which the symbol can be shifted (length of given sample array).
-                 *  \param  index
-                 *          The new start index in the window for the found upchirp.
-                 *  \return Also return the correlation coefficient.
-                 */
-                float sliding_norm_cross_correlate_upchirp(const float *samples_ifreq, const uint32_t window, int32_t *index);
-
-                /**
-                 *  \brief Base method to start downchirp correlation and return the correlation coefficient.
-                 *
-                 *  \param  samples
-                 *          The complex array of samples to detect a downchirp in.
-                 *  \param  window
-                 *          Length of said sample.
-                 */
-                float detect_downchirp(const gr_complex *samples, const uint32_t window);
-
-                /**
-                 *  \brief  Base method to start upchirp detection by calling `sliding_norm_cross_correlate_upchirp`.
-                 *          <br/>Sets up the instantaneous frequency of the given complex symbol.
-                 *
-                 *  \param  samples
-                 *          The complex array of samples to detect an upchirp in.
-                 *  \param  window
-                 *          Length of said sample.
-                 *  \param  index
-                 *          The index to shift with so the upchirp is correctly synced inside its window.
-                 *  \return Also return the correlation coefficient.
-                 */
-                float detect_upchirp(const gr_complex *samples, const uint32_t window, int32_t *index);
-
-                /**
-                 *  \brief  Returns the correlation coefficient when correlating the given complex symbols in the given window.
-                 *
-                 *  \param  samples_1
-                 *          The first complex symbol to correlate with.
-                 *  \param  samples_2
-                 *          The second complex symbol to correlate with.
-                 *  \param  window
-                 *          The window in which to perform correlation.
-                 */
-                float cross_correlate(const gr_complex *samples_1, const gr_complex *samples_2, const uint32_t window);
-
-                /**
-                 *  \brief  Returns the correlation coefficient of a real signal.
-                 *          See https://en.wikipedia.org/wiki/Cross-correlation#Normalized_cross-correlation.
-                 *
-                 *  \param  samples_ifreq
-                 *          The instantaneous frequency of the symbol to correlate with.
-                 *  \param  ideal_chirp
-                 *          The vector containing the ideal chirp to correlate with.
-                 *  \param  to_idx
-                 *          Correlation end index.
-                 */
-                float cross_correlate_ifreq(const float *samples_ifreq, const std::vector<float>& ideal_chirp, const uint32_t to_idx);
-
-                /**
-                 *  \brief  Returns the index of the bin containing the frequency change by using FFT.
-                 *
-                 *  \param  samples
-                 *          The complex symbol to analyse.
-                 */
-                uint32_t get_shift_fft(const gr_complex *samples);
-
-                /**
-                 *  \brief  Determine the center frequency offset in the given symbol.
-                 *
-                 *  \param  samples
-                 *          The complex symbol to analyse.
-                 */
-                void determine_cfo(const gr_complex *samples);
-
-                /**
-                 *  \brief  Determine the energy of a symbol.
-                 *
-                 *  \param  samples
-                 *          The complex symbol to analyse.
-                 */
-                float determine_energy(const gr_complex *samples);
-
-                /**
-                 *  \brief  Determine the SNR
-                 */
-                void determine_snr();
-
-                /**
-                 *  \brief  Returns the index of the bin containing the frequency change.
-                 *
-                 *  \param  samples
-                 *          The complex symbol to analyze.
-                 */
-                uint32_t max_frequency_gradient_idx(const gr_complex *samples);
-
-                /**
-                 *  \brief  Demodulate the given symbol and return true if all expected symbols have been parsed.
-                 *
-                 *  \param  samples
-                 *          The complex symbol to demodulate.
-                 *  \param  is_header
-                 *          Whether the demodulated words were from the HDR.
-                 */
-                bool demodulate(const gr_complex *samples, const bool reduced_rate);
-
-                /**
-                 *  \brief  Deinterleave the raw demodulated words by reversing the interleave pattern.
-                 *
-                 *  \param  ppm
-                 *          The number of words that zere interleaved. Depends on `SF`.
-                 */
-                void deinterleave(const uint32_t ppm);
+                phy_decoder_impl        d_phy;              ///< The receive chain.
+                std::vector<frame_sptr> d_frames;           ///< Frames completed by the current call to `general_work`.
+                std::vector<tag_t>      d_tags;             ///< `rx_time` tags of the current call to `general_work`.
+                uint32_t                d_samples_per_second; ///< The number of samples taken per second by GNU Radio.
 
-                /**
-                 *  \brief  The process of decoding the demodulated words to get the actual payload.
-                 *          <br/>1. Deshuffle the words
-                 *          <br/>2. Dewhiten the words
-                 *          <br/>3. Hamming decoding
-                 *
-                 *  \param  is_header
-                 *          Whether the demodulated words were from the HDR.
-                 */
-                void decode(const bool is_header);
+                std::atomic<double>   d_stats_interval;     ///< Seconds between two `stats` messages, or 0 to disable them.
+                boost::mutex          d_stats_mutex;        ///< Protects the `d_stats_` and `d_work_clock` members below.
+                boost::condition_variable d_stats_cond;     ///< Wakes the stats thread on stop or when the interval changes.
+                std::shared_ptr<boost::thread> d_stats_thread; ///< Publishes the `stats` messages.
+                bool                  d_stats_running;
+                bool                  d_work_clock_valid;   ///< Whether `general_work` ran since `start`, and `d_work_clock` is set.
+                clockid_t             d_work_clock;         ///< CPU time clock of the thread that runs `general_work`.
+                std::chrono::steady_clock::time_point d_stats_time; ///< When the last `stats` message was published.
+                double                d_stats_cpu_time;     ///< CPU time of the work thread when the last `stats` message was published.
+                double                d_stats_snr_sum;      ///< Sum of the finite SNRs (dB) of the payloads since the last `stats` message.
+                uint32_t              d_stats_snr_count;    ///< Number of payloads in `d_stats_snr_sum`.
+                std::atomic<int>      d_backlog;            ///< Input samples available to the last call to `general_work`.
 
-                /**
-                 *  \brief  Deshuffle the demodulated words by the given pattern.
-                 *
-                 *  \param  shuffle_pattern
-                 *          The order in which the bits appear.
-                 *  \param  is_header
-                 *          Whether the demodulated words were from the HDR.
-                 */
-                void deshuffle(const uint8_t *shuffle_pattern, const bool is_header);
+                std::vector<uint8_t>        d_stream_pending;   ///< Payload bytes not yet written to the byte stream output.
+                uint32_t                    d_stream_read;      ///< Read position in `d_stream_pending`.
+                std::deque<stream_packet_t> d_stream_packets;   ///< Packets with bytes in `d_stream_pending`, oldest first.
 
                 /**
-                 *  \brief  Dewhiten the deshuffled words by XORing with the whitening sequence.
-                 *
-                 *  \param  prng
-                 *          The whitening sequence to XOR with.
+                 *  \brief  Queue the payload of a decoded frame for the byte stream output.
                  */
-                void dewhiten(const uint8_t *prng);
+                void queue_stream_packet(const frame_sptr& f);
 
                 /**
-                 *  \brief  Use Hamming to decode the dewhitened words.
-                 *          <br/>- CR 4 or 3: Hamming(8,4) or Hamming(7,4) with parity correction
-                 *          <br/>- CR 2 or 1: Extract data only (can only find parity errors, not correct them)
+                 *  \brief  Write queued payload bytes to the byte stream output and tag the start of each packet
+                 *          with `packet_len`, `snr`, `cfo`, `sf`, `sample_offset` and `inverted_iq`.
                  *
-                 *  \param  is_header
-                 *          Decoding for the header?
+                 *  \param  out
+                 *          The byte stream output buffer.
+                 *  \param  noutput_items
+                 *          The space available in `out`.
+                 *  \return The number of bytes written.
                  */
-                void hamming_decode(bool is_header);
+                int produce_stream(uint8_t *out, const int noutput_items);
 
                 /**
-                 *  \brief  Extract only the data in the given bytes.
+                 *  \brief  Publish the counters, the mean SNR and CPU load since the previous call, and the input backlog
+                 *          as a dictionary on the `stats` port. Called with `d_stats_mutex` held.
                  *
-                 *  \param  is_header
-                 *          Decoding for the header?
+                 *  \param  now
+                 *          The current time.
                  */
-                void extract_data_only(bool is_header);
+                void publish_stats(const std::chrono::steady_clock::time_point now);
 
                 /**
-                 *  \brief  Hamming(8,4) decoding by calling `hamming_decode_soft_byte` on each byte.
-                 *          <BR>Each byte is decoded in pairs, the first one becoming the LSB nibble
-                 *          <BR>and the second one the MSB nibble (if even; else just zeroes).
-                 *
-                 *  \param  is_header
-                 *          Decoding for the header?
+                 *  \brief  Stats thread: publish every `d_stats_interval` seconds, whether or not input arrives.
                  */
-                void hamming_decode_soft(bool is_header);
-
-                /**
-                 *  \brief  Return the standard deviation for the given array.
-                 *          <br/>Used for cross correlating.
-                 *
-                 *  \param  values
-                 *          The array to calculate the standard deviation for.
-                 *  \param  len
-                 *          Length of said array.
-                 *  \param  mean
-                 *          The mean (average) of the values in the array.
-                 */
-                float stddev(const float *values, const uint32_t len, const float mean);
-
-                /**
-                 *  \brief  Calculate the instantaneous phase for the given complex symbol.
-                 *
-                 *  \param  in_samples
-                 *          The complex array to calculate the instantaneous phase for.
-                 *  \param  out_iphase
-                 *          The output `float` array containing the instantaneous phase.
-                 *  \param  window
-                 *          The size of said arrays.
-                 */
-                inline void instantaneous_phase(const gr_complex *in_samples, float *out_iphase, const uint32_t window);
-
-                /**
-                 *  \brief  Calculate the instantaneous frequency for the given complex symbol.
-                 *
-                 *  \param  in_samples
-                 *          The complex array to calculate the instantaneous frequency for.
-                 *  \param  out_ifreq
-                 *          The output `float` array containing the instantaneous frequency.
-                 *  \param  window
-                 *          The size of said arrays.
-                 */
-                inline void instantaneous_frequency(const gr_complex *in_samples, float *out_ifreq, const uint32_t window);
-
-                /**
-                 *  \brief  TODO
-                 */
-                void msg_lora_frame(void);
+                void stats_loop(void);
 
             public:
                 /**
@@ -422,8 +125,12 @@ namespace gr {
                  */
                 ~decoder_impl();
 
+                bool start();
+                bool stop();
+
                 /**
                 *   \brief  The main method called by GNU Radio to perform tasks on the given input.
+                *           <br/>Runs the receive chain over all available input but the last `lookahead()` samples.
                 *
                 *   \param  noutput_items
                 *           The requested amoutn of output items.
@@ -433,9 +140,15 @@ namespace gr {
                 *           An array to return processed samples.
                 *   \return Returns the number of output items generated.
                 */
-                int work(int noutput_items,
-                         gr_vector_const_void_star& input_items,
-                         gr_vector_void_star& output_items);
+                int general_work(int noutput_items,
+                                 gr_vector_int& ninput_items,
+                                 gr_vector_const_void_star& input_items,
+                                 gr_vector_void_star& output_items);
+
+                /**
+                 *  \brief  Every state needs two symbols of input, independently of how much output is requested.
+                 */
+                void forecast(int noutput_items, gr_vector_int& ninput_items_required);
 
                 /**
                  *  \brief  Set th current spreading factor.
@@ -453,6 +166,38 @@ namespace gr {
                  *          The new sample rate.
                  */
                 virtual void set_samp_rate(const float samp_rate);
+
+                uint64_t num_symbols(void)          { return d_phy.num_symbols(); }
+                uint64_t num_detections(void)       { return d_phy.num_detections(); }
+                uint64_t num_sfd_searches(void)     { return d_phy.num_sfd_searches(); }
+                uint64_t num_sync_aborts(void)      { return d_phy.num_sync_aborts(); }
+                uint64_t num_sync_word_aborts(void) { return d_phy.num_sync_word_aborts(); }
+                uint64_t num_headers(void)          { return d_phy.num_headers(); }
+                uint64_t num_header_aborts(void)    { return d_phy.num_header_aborts(); }
+                uint64_t num_inferred_implicit(void) { return d_phy.num_inferred_implicit(); }
+                uint64_t num_payloads(void)         { return d_phy.num_payloads(); }
+                uint64_t num_crc_errors(void)       { return d_phy.num_crc_errors(); }
+                uint64_t num_payload_aborts(void)   { return d_phy.num_payload_aborts(); }
+                uint64_t num_context_aborts(void)   { return d_phy.num_context_aborts(); }
+                std::map<std::string, uint64_t> state_ticks(void)                   { return d_phy.state_ticks(); }
+                std::map<std::string, uint64_t> state_visits(void)                  { return d_phy.state_visits(); }
+                std::vector<uint64_t> state_histogram(const std::string& state)     { return d_phy.state_histogram(state); }
+                void reset_counters(void)           { d_phy.reset_counters(); }
+                void set_stats_interval(const double seconds);
+                void set_drop_invalid(const bool drop)  { d_phy.set_drop_invalid(drop); }
+                void set_sync_words(const std::vector<uint8_t>& sync_words) { d_phy.set_sync_words(sync_words); }
+                void set_dual_polarity(const bool dual) { d_phy.set_dual_polarity(dual); }
+                void set_autodetect(const bool autodetect) { d_phy.set_autodetect(autodetect); }
+
+                /**
+                 *  \brief  Share of all ticks spent in each state, in `DecoderState` order. Exported to ControlPort.
+                 */
+                std::vector<float> state_load(void) { return d_phy.state_load(); }
+
+                /**
+                 *  \brief  Register the counters as ControlPort variables.
+                 */
+                void setup_rpc();
         };
     } // namespace lora
 } // namespace gr
@@ -0,0 +1,238 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+    #include "config.h"
+#endif
+
+#include <lora/encoder.h>
+#include <lora/loraphy.h>
+#include <lora/utilities.h>
+#include "tables.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace gr {
+    namespace lora {
+
+        encoder::encoder(float samp_rate, uint32_t bandwidth, uint8_t sf, uint8_t cr, bool crc, bool implicit, bool reduced_rate, uint16_t preamble_len, uint8_t sync_word)
+            : d_sf(sf),
+              d_cr(cr),
+              d_crc(crc),
+              d_implicit(implicit),
+              d_reduced_rate(reduced_rate),
+              d_preamble_len(preamble_len),
+              d_sync_word(sync_word),
+              d_phase(1.0, 0.0) {
+            if (sf < 6 || sf > 12)
+                throw std::invalid_argument("[LoRa Encoder] Spreading factor should be between 6 and 12 (inclusive)");
+            if (cr < 1 || cr > 4)
+                throw std::invalid_argument("[LoRa Encoder] Coding rate should be between 1 and 4 (inclusive)");
+            if (!implicit && sf < 7)
+                throw std::invalid_argument("[LoRa Encoder] An explicit header needs a spreading factor of at least 7");
+
+            const double oversampling = (double)samp_rate / bandwidth;
+            d_decim_factor = (uint32_t)std::lround(oversampling);
+            if (d_decim_factor == 0u || std::fabs(oversampling - d_decim_factor) > 1e-6)
+                throw std::invalid_argument("[LoRa Encoder] Sample rate should be an integer multiple of the bandwidth");
+
+            d_number_of_bins     = 1u << d_sf;
+            d_samples_per_symbol = d_number_of_bins * d_decim_factor;
+
+            // Same table selection as the decoder's dewhitening
+            d_prng        = (d_cr <= 2u) ? prng_payload_cr56 : prng_payload_cr78;
+            d_prng_length = (d_cr <= 2u) ? sizeof(prng_payload_cr56) : sizeof(prng_payload_cr78);
+
+            // Frequency rises linearly from -bandwidth/2 to +bandwidth/2 over one symbol
+            d_step.resize(d_samples_per_symbol);
+            for (uint32_t i = 0u; i < d_samples_per_symbol; i++)
+                d_step[i] = std::polar(1.0, M_PI * (2.0 * i / d_samples_per_symbol - 1.0) / d_decim_factor);
+
+            d_codewords.resize(d_sf);
+            d_nibbles.reserve(2u * (255u + MAC_CRC_SIZE));
+        }
+
+        uint32_t encoder::num_symbols(uint32_t length) const {
+            const uint32_t nibbles = 2u * (length + (d_crc ? MAC_CRC_SIZE : 0u));
+            const uint32_t first   = d_implicit ? d_sf - 2u : d_sf - 7u;   // Payload codewords in the header block
+            const uint32_t ppm     = d_reduced_rate ? d_sf - 2u : d_sf;
+            const uint32_t rest    = nibbles > first ? nibbles - first : 0u;
+
+            return 8u + (rest + ppm - 1u) / ppm * (4u + d_cr);
+        }
+
+        uint32_t encoder::frame_length(uint32_t length) const {
+            return (d_preamble_len + 2u + 2u + num_symbols(length)) * d_samples_per_symbol + d_samples_per_symbol / 4u;
+        }
+
+        /**
+         *  Hamming code a nibble and shuffle the bits into transmit order, the inverse of `deshuffle`.
+         *  Codewords in the header block are always sent at rate 4/8.
+         */
+        uint8_t encoder::codeword(uint8_t nibble, bool full) const {
+            static const uint8_t shuffle_pattern[] = {5, 0, 1, 2, 4, 3, 6, 7};
+
+            uint8_t w = hamming_encode_soft(nibble);
+
+            // 4/5 has a single parity bit over the whole nibble
+            if (!full && d_cr == 1u)
+                w = (w & ~0x10u) | ((uint8_t)!check_parity(nibble) << 4u);
+
+            uint8_t result = 0u;
+            for (uint32_t j = 0u; j < 8u; j++)
+                result |= ((w >> j) & 1u) << shuffle_pattern[j];
+
+            return full ? result : result & ((1u << (4u + d_cr)) - 1u);
+        }
+
+        /**
+         *  Spread `ppm` codewords of `bits` bits diagonally over `bits` symbols, the inverse of `deinterleave`,
+         *  and map each symbol to its chirp shift.
+         */
+        void encoder::interleave(const uint8_t* codewords, uint32_t ppm, uint32_t bits, bool reduced_rate, std::vector<uint32_t>& shifts) const {
+            for (uint32_t i = 0u; i < bits; i++) {
+                uint32_t word = 0u;
+                for (uint32_t x = 0u; x < ppm; x++)
+                    word |= ((codewords[x] >> i) & 1u) << x;
+
+                // The decoder Gray encodes the demodulated bin, so Gray decode the word
+                uint32_t bin = rotr(word, i, ppm);
+                for (uint32_t s = 1u; s < 16u; s <<= 1u)
+                    bin ^= bin >> s;
+
+                if (reduced_rate)
+                    bin *= 4u;
+
+                // A chirp shifted by k chips demodulates to bin k - 1
+                shifts.push_back((bin + 1u) % d_number_of_bins);
+            }
+        }
+
+        void encoder::encode(const uint8_t* payload, uint32_t length, std::vector<uint32_t>& shifts) {
+            static const uint8_t data_indices[4] = {1, 2, 3, 5};
+
+            if (length > 255u)
+                throw std::invalid_argument("[LoRa Encoder] Payload longer than 255 bytes");
+
+            shifts.clear();
+            d_nibbles.clear();
+
+            for (uint32_t i = 0u; i < length; i++) {
+                d_nibbles.push_back(payload[i] & 0x0fu);
+                d_nibbles.push_back(payload[i] >> 4u);
+            }
+
+            // The MAC CRC is sent little-endian and is not whitened
+            const uint32_t whitened = d_nibbles.size();
+            if (d_crc) {
+                const uint16_t crc = payload_crc(payload, length);
+                d_nibbles.push_back(crc & 0x0fu);
+                d_nibbles.push_back((crc >> 4u) & 0x0fu);
+                d_nibbles.push_back((crc >> 8u) & 0x0fu);
+                d_nibbles.push_back(crc >> 12u);
+            }
+
+            for (uint32_t n = 0u; n < whitened && n < d_prng_length; n++)
+                d_nibbles[n] ^= select_bits(d_prng[n], data_indices, 4u);
+
+            // Header block: the explicit header, filled up with the first payload codewords
+            const uint32_t ppm_hdr = d_sf - 2u;
+            uint32_t cw = 0u;
+            uint32_t n  = 0u;
+
+            if (!d_implicit) {
+                const uint8_t checksum = header_checksum_value(length, d_cr, d_crc);
+                loraphy_header_t hdr;
+
+                hdr.length      = length;
+                hdr.crc_msn     = checksum >> 4u;
+                hdr.has_mac_crc = d_crc;
+                hdr.cr          = d_cr;
+                hdr.crc_lsn     = 0u;
+                hdr.reserved    = checksum & 0x0fu;
+
+                const uint8_t* b = (const uint8_t*)&hdr;
+                const uint8_t header_nibbles[5] = {
+                    (uint8_t)(b[0] >> 4u), (uint8_t)(b[0] & 0x0fu), (uint8_t)(b[1] >> 4u), (uint8_t)(b[1] & 0x0fu), (uint8_t)(b[2] >> 4u)
+                };
+
+                for (; cw < 5u; cw++)
+                    d_codewords[cw] = codeword(header_nibbles[cw], true);
+            }
+
+            for (; cw < ppm_hdr; cw++, n++)
+                d_codewords[cw] = n < d_nibbles.size() ? codeword(d_nibbles[n], true) : 0u;
+
+            interleave(&d_codewords[0], ppm_hdr, 8u, true, shifts);
+
+            // Payload blocks, zero padded
+            const uint32_t ppm = d_reduced_rate ? d_sf - 2u : d_sf;
+
+            while (n < d_nibbles.size()) {
+                for (cw = 0u; cw < ppm; cw++, n++)
+                    d_codewords[cw] = n < d_nibbles.size() ? codeword(d_nibbles[n], false) : 0u;
+
+                interleave(&d_codewords[0], ppm, 4u + d_cr, d_reduced_rate, shifts);
+            }
+        }
+
+        /**
+         *  Write `length` samples of a chirp cyclically shifted by `shift` chips, continuing the current phase.
+         */
+        void encoder::chirp(uint32_t shift, bool down, uint32_t length, gr_complex* out) {
+            uint32_t idx = (shift % d_number_of_bins) * d_decim_factor;
+
+            for (uint32_t i = 0u; i < length; i++) {
+                out[i]   = gr_complex(d_phase);
+                d_phase *= down ? std::conj(d_step[idx]) : d_step[idx];
+
+                if (++idx == d_samples_per_symbol)
+                    idx = 0u;
+            }
+
+            // Keep rounding errors from building up over long runs
+            d_phase /= std::abs(d_phase);
+        }
+
+        void encoder::modulate(const uint8_t* payload, uint32_t length, std::vector<gr_complex>& out) {
+            encode(payload, length, d_shifts);
+
+            const uint32_t sps   = d_samples_per_symbol;
+            const size_t   start = out.size();
+            out.resize(start + frame_length(length));
+            gr_complex* o = &out[start];
+
+            for (uint32_t i = 0u; i < d_preamble_len; i++, o += sps)
+                chirp(0u, false, sps, o);
+
+            chirp((d_sync_word >> 4u) * 8u,    false, sps, o); o += sps;
+            chirp((d_sync_word & 0x0fu) * 8u,  false, sps, o); o += sps;
+
+            chirp(0u, true, sps, o);      o += sps;
+            chirp(0u, true, sps, o);      o += sps;
+            chirp(0u, true, sps / 4u, o); o += sps / 4u;
+
+            for (uint32_t shift : d_shifts) {
+                chirp(shift, false, sps, o);
+                o += sps;
+            }
+        }
+    }
+}
@@ -0,0 +1,135 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+    #include "config.h"
+#endif
+
+#include <lora/frame.h>
+#include <boost/any.hpp>
+
+namespace gr {
+    namespace lora {
+
+        frame::frame() : d_refcount(0u), d_payload_length(0u), d_timing(), d_channel(), d_crc(crc_status::NONE) {
+        }
+
+        void intrusive_ptr_add_ref(frame* f) {
+            f->d_refcount.fetch_add(1u, std::memory_order_relaxed);
+        }
+
+        /**
+         *  Return the frame to its pool once the last reference is gone. The pool reference is moved
+         *  out first, so that a pool whose owner already went away is destroyed only after the frame
+         *  was handed back.
+         */
+        void intrusive_ptr_release(frame* f) {
+            if (f->d_refcount.fetch_sub(1u, std::memory_order_acq_rel) != 1u)
+                return;
+
+            frame_pool::sptr pool = std::move(f->d_pool);
+            if (pool)
+                pool->recycle(f);
+            else
+                delete f;
+        }
+
+        frame_pool::sptr frame_pool::make(uint32_t num_frames) {
+            return std::make_shared<frame_pool>(num_frames);
+        }
+
+        frame_pool::frame_pool(uint32_t num_frames)
+            : d_frames(new frame[num_frames]),
+              d_exhausted(0u) {
+            d_free.reserve(num_frames);
+            for (uint32_t i = 0u; i < num_frames; i++)
+                d_free.push_back(&d_frames[i]);
+        }
+
+        frame_sptr frame_pool::acquire() {
+            frame* f = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(d_mutex);
+                if (!d_free.empty()) {
+                    f = d_free.back();
+                    d_free.pop_back();
+                }
+            }
+
+            if (f) {
+                f->d_pool = shared_from_this();
+            } else {
+                d_exhausted++;
+                f = new frame();
+            }
+
+            f->d_payload_length = 0u;
+            f->d_timing         = frame_timing_t();
+            f->d_channel        = frame_channel_t();
+            f->d_crc            = crc_status::NONE;
+            return frame_sptr(f);
+        }
+
+        uint32_t frame_pool::available() {
+            std::lock_guard<std::mutex> lock(d_mutex);
+            return d_free.size();
+        }
+
+        void frame_pool::recycle(frame* f) {
+            std::lock_guard<std::mutex> lock(d_mutex);
+            d_free.push_back(f);    // Never reallocates: capacity equals the number of pooled frames
+        }
+
+        pmt::pmt_t frame_to_blob(const frame_sptr& f) {
+            return pmt::make_blob(f->data(), f->size());
+        }
+
+        pmt::pmt_t frame_to_pmt(const frame_sptr& f) {
+            return pmt::make_any(boost::any(f));
+        }
+
+        frame_sptr frame_from_pmt(const pmt::pmt_t& msg) {
+            if (!pmt::is_any(msg))
+                return frame_sptr();
+
+            const boost::any value = pmt::any_ref(msg);
+            const frame_sptr* f = boost::any_cast<frame_sptr>(&value);
+
+            return f ? *f : frame_sptr();
+        }
+
+        bool frame_view(const pmt::pmt_t& msg, const uint8_t** data, size_t* size) {
+            if (pmt::is_blob(msg)) {
+                *data = (const uint8_t*)pmt::blob_data(msg);
+                *size = pmt::blob_length(msg);
+                return true;
+            }
+
+            // The frame stays referenced by `msg`, so the returned pointer outlives this call
+            frame_sptr f = frame_from_pmt(msg);
+            if (!f)
+                return false;
+
+            *data = f->data();
+            *size = f->size();
+            return true;
+        }
+    }
+}
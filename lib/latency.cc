@@ -0,0 +1,90 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+    #include "config.h"
+#endif
+
+#include <lora/latency.h>
+#include <lora/frame.h>
+#include <algorithm>
+#include <atomic>
+
+namespace gr {
+    namespace lora {
+        namespace latency {
+
+            typedef struct histogram {
+                std::atomic<uint64_t> buckets[LATENCY_HISTOGRAM_BINS];
+                std::atomic<uint64_t> count;
+                std::atomic<uint64_t> total_ns;
+            } histogram_t;
+
+            // Zero-initialized as a static
+            static histogram_t g_histograms[(size_t)latency_stage::NUM_STAGES];
+        }
+
+        void record_latency(latency_stage stage, int64_t ns) {
+            latency::histogram_t& h = latency::g_histograms[(size_t)stage];
+            ns = std::max(ns, (int64_t)0);
+            const uint64_t us       = ns / 1000u;
+            const uint32_t bucket   = us ? std::min(63u - __builtin_clzll(us), LATENCY_HISTOGRAM_BINS - 1u) : 0u;
+
+            // Several sinks may record the same stage from their own threads
+            h.buckets[bucket].fetch_add(1u, std::memory_order_relaxed);
+            h.count.fetch_add(1u, std::memory_order_relaxed);
+            h.total_ns.fetch_add(ns, std::memory_order_relaxed);
+        }
+
+        void record_frame_latency(latency_stage stage, const pmt::pmt_t& msg) {
+            const frame_sptr f = frame_from_pmt(msg);
+            if (!f || !latency_origin_ns(f->timing()))
+                return;
+
+            record_latency(stage, (int64_t)(wall_time_ns() - latency_origin_ns(f->timing())));
+        }
+
+        std::vector<uint64_t> latency_histogram(latency_stage stage) {
+            const latency::histogram_t& h = latency::g_histograms[(size_t)stage];
+            std::vector<uint64_t> result(LATENCY_HISTOGRAM_BINS);
+
+            for (uint32_t i = 0u; i < LATENCY_HISTOGRAM_BINS; i++)
+                result[i] = h.buckets[i].load(std::memory_order_relaxed);
+
+            return result;
+        }
+
+        double latency_mean(latency_stage stage) {
+            const latency::histogram_t& h = latency::g_histograms[(size_t)stage];
+            const uint64_t count = h.count.load(std::memory_order_relaxed);
+
+            return count ? h.total_ns.load(std::memory_order_relaxed) / 1e3 / count : 0.0;
+        }
+
+        void reset_latency() {
+            for (latency::histogram_t& h : latency::g_histograms) {
+                for (std::atomic<uint64_t>& b : h.buckets)
+                    b.store(0u, std::memory_order_relaxed);
+                h.count.store(0u, std::memory_order_relaxed);
+                h.total_ns.store(0u, std::memory_order_relaxed);
+            }
+        }
+    }
+}
@@ -0,0 +1,346 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+    #include "config.h"
+#endif
+
+#include "logger.h"
+#include <boost/thread.hpp>
+#include <iostream>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LOG_IDLE_WAIT_MS 10u        ///< Formatter poll interval when the queue is empty.
+#define LOG_LINE_SIZE    2048u
+
+namespace gr {
+    namespace lora {
+        namespace logging {
+
+            // Frames are printed by default, as the decoder always did; everything else only warns.
+            std::atomic<uint8_t> g_levels[(size_t)log_category::NUM_CATEGORIES] = {
+                { (uint8_t)log_level::WARN },   // SYNC
+                { (uint8_t)log_level::WARN },   // DEMOD
+                { (uint8_t)log_level::WARN },   // DECODE
+                { (uint8_t)log_level::INFO },   // FRAME
+            };
+
+            static const char* category_names[] = { "sync", "demod", "decode", "frame" };
+            static const char* level_names[]    = { "off", "error", "warn", "info", "debug", "trace" };
+
+            /**
+             *  \brief  Bounded multi-producer queue of log records (Vyukov's sequence-numbered ring), drained by
+             *          a single formatter thread that owns the output file.
+             */
+            class log_writer {
+                private:
+                    typedef struct cell {
+                        std::atomic<size_t> sequence;
+                        log_record_t        record;
+                    } cell_t;
+
+                    cell_t                  d_cells[LOG_QUEUE_SIZE];
+                    std::atomic<size_t>     d_enqueue_pos;
+                    size_t                  d_dequeue_pos;      ///< Only used by the formatter thread.
+                    std::atomic<uint64_t>   d_dropped;
+
+                    boost::mutex            d_file_mutex;       ///< Protects `d_file`.
+                    FILE*                   d_file;
+                    std::atomic<bool>       d_running;
+                    boost::thread           d_thread;
+
+                    bool dequeue(log_record_t& record);
+                    void format(const log_record_t& record);
+                    void run();
+
+                public:
+                    log_writer();
+                    ~log_writer();
+
+                    log_record_t* claim(void** slot);
+                    void          commit(void* slot);
+                    void          set_file(const std::string& path);
+                    uint64_t      dropped() const { return d_dropped; }
+            };
+
+            log_writer::log_writer()
+                : d_enqueue_pos(0u),
+                  d_dequeue_pos(0u),
+                  d_dropped(0u),
+                  d_file(stdout),
+                  d_running(true) {
+                for (size_t i = 0u; i < LOG_QUEUE_SIZE; i++)
+                    d_cells[i].sequence.store(i, std::memory_order_relaxed);
+
+                const char* path = getenv("GRLORA_LOG_FILE");
+                if (path)
+                    set_file(path);
+
+                d_thread = boost::thread(boost::bind(&log_writer::run, this));
+            }
+
+            log_writer::~log_writer() {
+                d_running = false;
+                d_thread.join();
+
+                if (d_file != stdout)
+                    fclose(d_file);
+            }
+
+            log_record_t* log_writer::claim(void** slot) {
+                size_t pos = d_enqueue_pos.load(std::memory_order_relaxed);
+
+                while (true) {
+                    cell_t* c = &d_cells[pos & (LOG_QUEUE_SIZE - 1u)];
+                    const intptr_t diff = (intptr_t)c->sequence.load(std::memory_order_acquire) - (intptr_t)pos;
+
+                    if (diff == 0) {
+                        if (d_enqueue_pos.compare_exchange_weak(pos, pos + 1u, std::memory_order_relaxed)) {
+                            *slot = c;
+                            return &c->record;
+                        }
+                    } else if (diff < 0) {
+                        d_dropped++;    // Full: never block the caller
+                        return nullptr;
+                    } else {
+                        pos = d_enqueue_pos.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            void log_writer::commit(void* slot) {
+                cell_t* c = (cell_t*)slot;
+                c->sequence.store(c->sequence.load(std::memory_order_relaxed) + 1u, std::memory_order_release);
+            }
+
+            bool log_writer::dequeue(log_record_t& record) {
+                cell_t* c = &d_cells[d_dequeue_pos & (LOG_QUEUE_SIZE - 1u)];
+
+                if (c->sequence.load(std::memory_order_acquire) != d_dequeue_pos + 1u)
+                    return false;
+
+                record = c->record;
+                c->sequence.store(d_dequeue_pos + LOG_QUEUE_SIZE, std::memory_order_release);
+                d_dequeue_pos++;
+                return true;
+            }
+
+            void log_writer::set_file(const std::string& path) {
+                FILE* f = stdout;
+
+                if (!path.empty() && !(f = fopen(path.c_str(), "a"))) {
+                    std::cerr << "[LoRa] WARNING : Cannot open log file " << path << ", logging to stdout." << std::endl;
+                    f = stdout;
+                }
+
+                boost::mutex::scoped_lock lock(d_file_mutex);
+                if (d_file != stdout)
+                    fclose(d_file);
+                d_file = f;
+            }
+
+            /**
+             *  Append to a line buffer, clamping at its end.
+             */
+            static size_t append(char* line, size_t n, const char* format, ...) __attribute__((format(printf, 3, 4)));
+            static size_t append(char* line, size_t n, const char* format, ...) {
+                va_list args;
+                va_start(args, format);
+                const int written = vsnprintf(line + n, LOG_LINE_SIZE - n, format, args);
+                va_end(args);
+
+                return std::min(n + std::max(written, 0), (size_t)LOG_LINE_SIZE - 1u);
+            }
+
+            /**
+             *  Expand the `{}` placeholders of a record and write it as one line.
+             */
+            void log_writer::format(const log_record_t& record) {
+                char line[LOG_LINE_SIZE];
+                size_t n = append(line, 0u, "%.6f [%s] %s: ",
+                                  record.timestamp_ns / 1e9,
+                                  category_names[(size_t)record.category],
+                                  level_names[(size_t)record.level]);
+                uint32_t arg = 0u;
+
+                for (const char* p = record.format; *p && n < LOG_LINE_SIZE - 1u; p++) {
+                    if (p[0] != '{' || p[1] != '}' || arg >= record.num_args) {
+                        line[n++] = *p;
+                        continue;
+                    }
+                    p++;
+
+                    const log_arg_t& a = record.args[arg++];
+                    switch (a.type) {
+                        case arg_type::INT:    n = append(line, n, "%lld", (long long)a.i);          break;
+                        case arg_type::UINT:   n = append(line, n, "%llu", (unsigned long long)a.u); break;
+                        case arg_type::DOUBLE: n = append(line, n, "%g", a.d);                       break;
+                        case arg_type::STRING: n = append(line, n, "%s", a.s);                       break;
+                        case arg_type::HEX: {
+                            for (uint32_t i = 0u; i < record.num_bytes; i++)
+                                n = append(line, n, " %02x", record.bytes[i]);
+
+                            n = append(line, n, " (");
+                            for (uint32_t i = 0u; i < record.num_bytes && n < LOG_LINE_SIZE - 1u; i++) {
+                                if (record.bytes[i] >= ' ' && record.bytes[i] <= '~')
+                                    line[n++] = record.bytes[i];
+                            }
+                            n = append(line, n, ")");
+                            break;
+                        }
+                        case arg_type::BIN: {
+                            for (uint32_t i = 0u; i < record.num_bytes && n < LOG_LINE_SIZE - 11u; i++) {
+                                for (int32_t b = 7; b >= 0; b--)
+                                    line[n++] = (record.bytes[i] >> b) & 1u ? '1' : '0';
+                                line[n++] = ',';
+                                line[n++] = ' ';
+                            }
+                            break;
+                        }
+                    }
+                }
+
+                line[n++] = '\n';
+                fwrite(line, 1, n, d_file);
+            }
+
+            void log_writer::run() {
+                log_record_t record;
+
+                while (true) {
+                    bool wrote = false;
+                    {
+                        boost::mutex::scoped_lock lock(d_file_mutex);
+                        while (dequeue(record)) {
+                            format(record);
+                            wrote = true;
+                        }
+
+                        if (wrote)
+                            fflush(d_file);
+                    }
+
+                    if (!wrote) {
+                        if (!d_running)
+                            return;
+
+                        boost::this_thread::sleep_for(boost::chrono::milliseconds(LOG_IDLE_WAIT_MS));
+                    }
+                }
+            }
+
+            static log_writer& writer() {
+                static log_writer instance;
+                return instance;
+            }
+
+            log_record_t* claim(void** slot) {
+                return writer().claim(slot);
+            }
+
+            void commit(void* slot) {
+                writer().commit(slot);
+            }
+
+            static bool parse_level(const std::string& s, log_level* level) {
+                for (size_t i = 0u; i < sizeof(level_names) / sizeof(level_names[0]); i++) {
+                    if (s == level_names[i]) {
+                        *level = (log_level)i;
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            static bool apply_environment() {
+                const char* spec = getenv("GRLORA_LOG");
+                if (spec && !set_log_levels(spec))
+                    std::cerr << "[LoRa] WARNING : Could not fully parse GRLORA_LOG=" << spec << std::endl;
+
+                return true;
+            }
+
+            static const bool environment_applied = apply_environment();
+        }
+
+        void set_log_level(log_category category, log_level level) {
+            logging::g_levels[(size_t)category].store((uint8_t)level, std::memory_order_relaxed);
+        }
+
+        log_level get_log_level(log_category category) {
+            return (log_level)logging::g_levels[(size_t)category].load(std::memory_order_relaxed);
+        }
+
+        bool set_log_levels(const std::string& spec) {
+            bool ok = true;
+            size_t start = 0u;
+
+            while (start <= spec.size()) {
+                size_t end = spec.find(',', start);
+                if (end == std::string::npos)
+                    end = spec.size();
+
+                const std::string item = spec.substr(start, end - start);
+                const size_t eq = item.find('=');
+                log_level level;
+
+                if (item.empty()) {
+                    // Tolerate stray commas
+                } else if (eq == std::string::npos) {
+                    if (logging::parse_level(item, &level)) {
+                        for (size_t c = 0u; c < (size_t)log_category::NUM_CATEGORIES; c++)
+                            set_log_level((log_category)c, level);
+                    } else {
+                        ok = false;
+                    }
+                } else if (logging::parse_level(item.substr(eq + 1u), &level)) {
+                    const std::string name = item.substr(0u, eq);
+                    bool found = false;
+
+                    for (size_t c = 0u; c < (size_t)log_category::NUM_CATEGORIES; c++) {
+                        if (name == "all" || name == logging::category_names[c]) {
+                            set_log_level((log_category)c, level);
+                            found = true;
+                        }
+                    }
+
+                    ok = ok && found;
+                } else {
+                    ok = false;
+                }
+
+                start = end + 1u;
+            }
+
+            return ok;
+        }
+
+        void set_log_file(const std::string& path) {
+            logging::writer().set_file(path);
+        }
+
+        uint64_t log_dropped() {
+            return logging::writer().dropped();
+        }
+    }
+}
@@ -0,0 +1,158 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LORA_LOGGER_H
+#define INCLUDED_LORA_LOGGER_H
+
+#include <lora/logging.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string.h>
+#include <type_traits>
+
+#define LOG_QUEUE_SIZE  1024u       ///< Records the formatter may lag behind. Must be a power of two.
+#define LOG_MAX_ARGS    8u          ///< Scalar arguments per record.
+#define LOG_MAX_BYTES   (255u + 2u) ///< Inline byte array per record, enough for a full PHY payload.
+
+/**
+ *  \brief  Log a record if `CATEGORY` is enabled at `LEVEL`. When it is not, this costs a single relaxed load.
+ *          <br/>The format uses `{}` placeholders and must be a string literal. Arguments are copied in binary
+ *          form; formatting happens on the logger thread. String arguments must outlive the program (literals).
+ *
+ *          GRLORA_LOG(SYNC, DEBUG, "Ca: {}", correlation);
+ */
+#define GRLORA_LOG(CATEGORY, LEVEL, ...)                                                                    \
+    do {                                                                                                    \
+        if (gr::lora::logging::enabled(gr::lora::log_category::CATEGORY, gr::lora::log_level::LEVEL))       \
+            gr::lora::logging::write(gr::lora::log_category::CATEGORY, gr::lora::log_level::LEVEL, __VA_ARGS__); \
+    } while(0)
+
+namespace gr {
+    namespace lora {
+        namespace logging {
+
+            enum class arg_type : uint8_t { INT, UINT, DOUBLE, STRING, HEX, BIN };
+
+            /**
+             *  \brief  A single argument, stored without formatting.
+             */
+            typedef struct log_arg {
+                arg_type type;
+                union {
+                    int64_t     i;
+                    uint64_t    u;
+                    double      d;
+                    const char* s;
+                };
+            } log_arg_t;
+
+            /**
+             *  \brief  Fixed-size binary log record. Byte arrays are copied inline, at most one per record.
+             */
+            typedef struct log_record {
+                uint64_t     timestamp_ns;              ///< Steady clock time of the call.
+                log_category category;
+                log_level    level;
+                const char*  format;
+                uint8_t      num_args;
+                log_arg_t    args[LOG_MAX_ARGS];
+                uint16_t     num_bytes;
+                uint8_t      bytes[LOG_MAX_BYTES];
+            } log_record_t;
+
+            /**
+             *  \brief  Byte array argument, printed in hex (with printable characters) or binary.
+             */
+            typedef struct bytes_arg {
+                const uint8_t* data;
+                uint32_t       length;
+                arg_type       type;
+            } bytes_arg_t;
+
+            inline bytes_arg_t hex(const uint8_t* data, uint32_t length) { return { data, length, arg_type::HEX }; }
+            inline bytes_arg_t bin(const uint8_t* data, uint32_t length) { return { data, length, arg_type::BIN }; }
+
+            extern std::atomic<uint8_t> g_levels[(size_t)log_category::NUM_CATEGORIES];
+
+            inline bool enabled(log_category category, log_level level) {
+                return g_levels[(size_t)category].load(std::memory_order_relaxed) >= (uint8_t)level;
+            }
+
+            /**
+             *  \brief  Claim a slot in the lock-free record queue, or return `nullptr` (and count a drop) when full.
+             *          The slot must be handed back with `commit`.
+             */
+            log_record_t* claim(void** slot);
+            void          commit(void* slot);
+
+            template <typename T>
+            inline typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+            set_arg(log_record_t& r, T value) { r.args[r.num_args].type = arg_type::INT;    r.args[r.num_args++].i = value; }
+
+            template <typename T>
+            inline typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value>::type
+            set_arg(log_record_t& r, T value) { r.args[r.num_args].type = arg_type::UINT;   r.args[r.num_args++].u = value; }
+
+            template <typename T>
+            inline typename std::enable_if<std::is_floating_point<T>::value>::type
+            set_arg(log_record_t& r, T value) { r.args[r.num_args].type = arg_type::DOUBLE; r.args[r.num_args++].d = value; }
+
+            inline void set_arg(log_record_t& r, const char* value) { r.args[r.num_args].type = arg_type::STRING; r.args[r.num_args++].s = value; }
+
+            inline void set_arg(log_record_t& r, const bytes_arg_t& value) {
+                r.num_bytes = std::min(value.length, LOG_MAX_BYTES);
+                memcpy(r.bytes, value.data, r.num_bytes);
+                r.args[r.num_args].type = value.type;
+                r.args[r.num_args++].u  = r.num_bytes;
+            }
+
+            inline void set_args(log_record_t& r) { (void) r; }
+
+            template <typename T, typename... Args>
+            inline void set_args(log_record_t& r, const T& value, const Args&... args) {
+                set_arg(r, value);
+                set_args(r, args...);
+            }
+
+            template <typename... Args>
+            void write(log_category category, log_level level, const char* format, const Args&... args) {
+                static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "Too many log arguments");
+
+                void* slot;
+                log_record_t* r = claim(&slot);
+                if (!r)
+                    return;
+
+                r->timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+                r->category     = category;
+                r->level        = level;
+                r->format       = format;
+                r->num_args     = 0u;
+                r->num_bytes    = 0u;
+                set_args(*r, args...);
+
+                commit(slot);
+            }
+        }
+    }
+}
+
+#endif /* INCLUDED_LORA_LOGGER_H */
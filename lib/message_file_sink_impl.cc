@@ -680,6 +680,8 @@
 #endif
 
 #include <gnuradio/io_signature.h>
+#include <lora/frame.h>
+#include <lora/latency.h>
 #include "message_file_sink_impl.h"
 
 namespace gr {
@@ -716,10 +718,15 @@ namespace gr {
      * Incoming message handler
      */
     void message_file_sink_impl::msg_handler(pmt::pmt_t msg) {
-        const char* data = (const char*) pmt::blob_data(msg);
-        size_t size = pmt::blob_length(msg);
-        d_file.write(data, size);
+        const uint8_t* data;
+        size_t size;
+
+        if(!frame_view(msg, &data, &size))
+            return;
+
+        d_file.write((const char*) data, size);
         d_file.flush();
+        record_frame_latency(latency_stage::FILE_SINK, msg);
     }
 
   } /* namespace lora */
@@ -0,0 +1,272 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+    #include "config.h"
+#endif
+
+#include <lora/loratap.h>
+#include <lora/loraphy.h>
+#include <lora/frame.h>
+#include <gnuradio/io_signature.h>
+#include <lora/utilities.h>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/uri.hpp>
+#include <mongocxx/exception/exception.hpp>
+#include <stdexcept>
+#include "message_mongodb_sink_impl.h"
+
+#define MONGODB_MAX_RETRIES    5u
+#define MONGODB_RETRY_DELAY_MS 100u
+
+namespace gr {
+    namespace lora {
+
+        /**
+         *  \brief  The driver instance, which must exist exactly once per process and before any other
+         *          mongocxx object, including a `mongocxx::uri`.
+         */
+        static mongocxx::instance& mongodb_instance() {
+            static mongocxx::instance instance{};
+            return instance;
+        }
+
+        static uint32_t positive(int value, const std::string& name) {
+            if (value <= 0)
+                throw std::invalid_argument("[LoRa MongoDB Sink] " + name + " should be positive");
+
+            return (uint32_t)value;
+        }
+
+        message_mongodb_sink::sptr message_mongodb_sink::make(const std::string& ip, int port, const std::string& db, const std::string& collection, const std::string& tag, int batch_size, int flush_ms, int max_queued) {
+            return gnuradio::get_initial_sptr(new message_mongodb_sink_impl(ip, port, db, collection, tag, batch_size, flush_ms, max_queued));
+        }
+
+        /**
+         *  \brief  The private constructor
+         *
+         *      Only sets up the queue and checks the URI; the database connection is owned by the writer thread.
+         */
+        message_mongodb_sink_impl::message_mongodb_sink_impl(const std::string& ip, int port, const std::string& db, const std::string& collection, const std::string& tag, int batch_size, int flush_ms, int max_queued)
+            : gr::block("message_mongodb_sink", gr::io_signature::make(0, 0, 0), gr::io_signature::make(0, 0, 0)),
+            d_uri("mongodb://" + ip + ":" + std::to_string(port)),
+            d_db(db),
+            d_collection(collection),
+            d_tag(tag),
+            d_batch_size(positive(batch_size, "The batch size")),
+            d_flush_interval(std::max(flush_ms, 1)),
+            d_queue(std::max(positive(max_queued, "The maximum number of queued frames"), d_batch_size)),
+            d_running(false),
+            d_inserted(0),
+            d_dropped(0) {
+
+            // Parsed here rather than in the writer thread, where an exception would terminate the process
+            mongodb_instance();
+            try {
+                mongocxx::uri uri{d_uri};
+            } catch (const mongocxx::exception& e) {
+                throw std::invalid_argument("[LoRa MongoDB Sink] Invalid server address " + d_uri + ": " + e.what());
+            }
+
+            message_port_register_in(pmt::mp("in"));
+            set_msg_handler(pmt::mp("in"), boost::bind(&message_mongodb_sink_impl::handle, this, boost::placeholders::_1));
+        }
+
+        /**
+         *  \brief  Our virtual destructor.
+         */
+        message_mongodb_sink_impl::~message_mongodb_sink_impl() {
+            stop();
+        }
+
+        bool message_mongodb_sink_impl::start() {
+            boost::mutex::scoped_lock lock(d_mutex);
+            if (!d_running) {
+                d_running = true;
+                d_thread  = std::shared_ptr<boost::thread>(new boost::thread(boost::bind(&message_mongodb_sink_impl::msg_write_mongodb, this)));
+            }
+
+            return block::start();
+        }
+
+        /**
+         *  \brief  Stop the writer thread after it has flushed the queue.
+         */
+        bool message_mongodb_sink_impl::stop() {
+            {
+                boost::mutex::scoped_lock lock(d_mutex);
+                d_running = false;
+            }
+            d_cond.notify_one();
+
+            if (d_thread) {
+                d_thread->join();
+                d_thread.reset();
+            }
+
+            return block::stop();
+        }
+
+        uint64_t message_mongodb_sink_impl::num_inserted() const {
+            return d_inserted;
+        }
+
+        uint64_t message_mongodb_sink_impl::num_dropped() const {
+            return d_dropped;
+        }
+
+        /**
+         *  \brief  Queue a frame for the writer thread. Never blocks on the database.
+         */
+        void message_mongodb_sink_impl::handle(pmt::pmt_t msg) {
+            const uint8_t* data;
+            size_t size;
+
+            if (!gr::lora::frame_view(msg, &data, &size))
+                return;
+
+            mongodb_record_t record;
+            record.date = std::chrono::system_clock::now();
+            record.data.assign(data, data + size);
+
+            bool notify;
+            {
+                boost::mutex::scoped_lock lock(d_mutex);
+                if (d_queue.full())
+                    d_dropped++;
+
+                d_queue.push_back(std::move(record));
+                notify = d_queue.size() >= d_batch_size;
+            }
+
+            if (notify)
+                d_cond.notify_one();
+        }
+
+        /**
+         *  \brief  Writer thread: collect up to `d_batch_size` frames, or whatever arrived within
+         *          the flush interval, and insert them with a single unordered bulk write.
+         *          <br/>Failed batches are retried with exponential backoff before being dropped. Once `stop`
+         *          was called, they are dropped after a single attempt, so that stopping is not held up by an
+         *          unreachable server.
+         */
+        void message_mongodb_sink_impl::msg_write_mongodb() {
+            mongodb_instance();
+
+            mongocxx::client     client;
+            mongocxx::collection collection;
+            try {
+                client     = mongocxx::client{mongocxx::uri{d_uri}};
+                collection = client[d_db][d_collection];
+            } catch (const mongocxx::exception& e) {
+                // Every batch is then dropped, and counted as such
+                std::cerr << "[message_mongodb_sink] Failed to connect to " << d_uri << ": " << e.what() << std::endl;
+            }
+            mongocxx::options::insert options;
+            options.ordered(false);
+
+            std::vector<mongodb_record_t>           batch;
+            std::vector<bsoncxx::document::value>   documents;
+            batch.reserve(d_batch_size);
+            documents.reserve(d_batch_size);
+            bool running = true;
+
+            while (running) {
+                {
+                    boost::mutex::scoped_lock lock(d_mutex);
+                    d_cond.wait_for(lock, boost::chrono::milliseconds(d_flush_interval.count()), [this] {
+                        return !d_running || d_queue.size() >= d_batch_size;
+                    });
+
+                    running = d_running;
+                    while (!d_queue.empty() && batch.size() < d_batch_size) {
+                        batch.push_back(std::move(d_queue.front()));
+                        d_queue.pop_front();
+                    }
+
+                    // Keep draining without waiting when stopping with a backlog
+                    if (!running && !d_queue.empty())
+                        running = true;
+                }
+
+                if (batch.empty())
+                    continue;
+
+                if (!client) {
+                    d_dropped += batch.size();
+                    batch.clear();
+                    continue;
+                }
+
+                for (const mongodb_record_t& record : batch) {
+                    using bsoncxx::builder::basic::kvp;
+
+                    const loratap_header_t* loratap_header = nullptr;
+                    const loraphy_header_t* loraphy_header = nullptr;
+                    bsoncxx::builder::basic::document document{};
+
+                    document.append(kvp("date",  bsoncxx::types::b_date{record.date}),
+                                    kvp("tag",   d_tag),
+                                    kvp("chirp", bsoncxx::types::b_binary{bsoncxx::binary_sub_type::k_binary, (uint32_t)record.data.size(), record.data.data()}));
+
+                    if (record.data.size() >= sizeof(loratap_header_t) + sizeof(loraphy_header_t)) {
+                        uint32_t offset = gr::lora::dissect_packet((const void **)&loratap_header, sizeof(loratap_header_t), record.data.data(), 0);
+                        gr::lora::dissect_packet((const void **)&loraphy_header, sizeof(loraphy_header_t), record.data.data(), offset);
+
+                        document.append(kvp("sf",     (int32_t)loratap_header->channel.sf),
+                                        kvp("snr",    (int32_t)loratap_header->rssi.snr),
+                                        kvp("length", (int32_t)loraphy_header->length));
+                    }
+
+                    documents.push_back(document.extract());
+                }
+
+                for (uint32_t attempt = 0u; ; attempt++) {
+                    try {
+                        collection.insert_many(documents, options);
+                        d_inserted += batch.size();
+                        break;
+                    } catch (const mongocxx::exception& e) {
+                        boost::mutex::scoped_lock lock(d_mutex);
+
+                        if (!d_running || attempt + 1u >= MONGODB_MAX_RETRIES) {
+                            std::cerr << "[message_mongodb_sink] Dropping " << batch.size() << " frames: " << e.what() << std::endl;
+                            d_dropped += batch.size();
+                            break;
+                        }
+
+                        // Cut short by `stop`, after which the next attempt is the last
+                        d_cond.wait_for(lock, boost::chrono::milliseconds(MONGODB_RETRY_DELAY_MS << attempt), [this] {
+                            return !d_running;
+                        });
+                    }
+                }
+
+                batch.clear();
+                documents.clear();
+            }
+        }
+
+    } /* namespace lora */
+} /* namespace gr */
@@ -0,0 +1,78 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LORA_MESSAGE_MONGODB_SINK_IMPL_H
+#define INCLUDED_LORA_MESSAGE_MONGODB_SINK_IMPL_H
+
+#include <lora/message_mongodb_sink.h>
+#include <boost/circular_buffer.hpp>
+#include <boost/thread.hpp>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace gr {
+    namespace lora {
+
+        /**
+         *  \brief  A frame waiting in the queue to be inserted.
+         */
+        typedef struct mongodb_record {
+            std::chrono::system_clock::time_point date;     ///< Time at which the frame was received by the sink.
+            std::vector<uint8_t>                  data;     ///< LoRaTap frame.
+        } mongodb_record_t;
+
+        class message_mongodb_sink_impl : public message_mongodb_sink {
+            private:
+                const std::string d_uri;
+                const std::string d_db;
+                const std::string d_collection;
+                const std::string d_tag;
+                const uint32_t    d_batch_size;
+                const std::chrono::milliseconds d_flush_interval;
+
+                boost::circular_buffer<mongodb_record_t> d_queue;   ///< Frames waiting for the writer thread. Overwrites the oldest frame when full.
+                boost::mutex                d_mutex;                ///< Protects `d_queue` and `d_running`.
+                boost::condition_variable   d_cond;                 ///< Wakes the writer when a batch is full or on stop.
+                std::shared_ptr<boost::thread> d_thread;            ///< Writer thread.
+                bool                        d_running;
+
+                std::atomic<uint64_t>       d_inserted;
+                std::atomic<uint64_t>       d_dropped;
+
+                void handle(pmt::pmt_t msg);
+                void msg_write_mongodb();
+
+            public:
+                message_mongodb_sink_impl(const std::string& ip, int port, const std::string& db, const std::string& collection, const std::string& tag, int batch_size, int flush_ms, int max_queued);
+                ~message_mongodb_sink_impl();
+
+                bool start();
+                bool stop();
+
+                uint64_t num_inserted() const;
+                uint64_t num_dropped() const;
+        };
+
+    } // namespace lora
+} // namespace gr
+
+#endif /* INCLUDED_LORA_MESSAGE_MONGODB_SINK_IMPL_H */
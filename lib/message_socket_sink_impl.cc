@@ -24,6 +24,8 @@
 
 #include <lora/loratap.h>
 #include <lora/loraphy.h>
+#include <lora/frame.h>
+#include <lora/latency.h>
 #include <gnuradio/io_signature.h>
 #include <lora/utilities.h>
 #include "message_socket_sink_impl.h"
@@ -83,11 +85,15 @@ namespace gr {
          *  \brief  Handle a message and send its contents through an UDP packet to the loopback interface.
          */
         void message_socket_sink_impl::handle(pmt::pmt_t msg) {
-            uint8_t* data = (uint8_t*)pmt::blob_data(msg);
-            size_t size = pmt::blob_length(msg);
+            const uint8_t* data;
+            size_t size;
+
+            if (!gr::lora::frame_view(msg, &data, &size))
+                return;
 
             //offset = gr::lora::dissect_packet((const void **)&loratap_header, sizeof(loratap_header_t), data, offset);
             msg_send_udp(data, size); // Send message over UDP socket
+            record_frame_latency(latency_stage::SOCKET_SINK, msg);
         }
 
         void message_socket_sink_impl::msg_send_udp(const uint8_t* data, const uint32_t length) {
@@ -104,7 +110,7 @@ namespace gr {
                     msg = data + sizeof(loratap_header_t);
                     break;
                 case LORAMAC:
-                    loraphy_header_t* loraphy_header;
+                    const loraphy_header_t* loraphy_header;
                     gr::lora::dissect_packet((const void **)&loraphy_header, sizeof(loraphy_header_t), data, sizeof(loratap_header_t));
                     msg_len = length - sizeof(loratap_header_t) - sizeof(loraphy_header_t) - (MAC_CRC_SIZE * loraphy_header->has_mac_crc);
                     msg = data + sizeof(loratap_header_t) + sizeof(loraphy_header_t);
@@ -0,0 +1,149 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+    #include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include "modulator_impl.h"
+#include <algorithm>
+#include <iostream>
+#include <string.h>
+
+namespace gr {
+    namespace lora {
+
+        modulator::sptr modulator::make(float samp_rate, uint32_t bandwidth, uint8_t sf, uint8_t cr, bool crc, bool implicit, bool reduced_rate, uint16_t preamble_len, uint8_t sync_word, uint32_t gap_symbols) {
+            return gnuradio::get_initial_sptr
+                   (new modulator_impl(samp_rate, bandwidth, sf, cr, crc, implicit, reduced_rate, preamble_len, sync_word, gap_symbols));
+        }
+
+        /**
+         * The private constructor
+         */
+        modulator_impl::modulator_impl(float samp_rate, uint32_t bandwidth, uint8_t sf, uint8_t cr, bool crc, bool implicit, bool reduced_rate, uint16_t preamble_len, uint8_t sync_word, uint32_t gap_symbols)
+            : gr::sync_block("modulator",
+                             gr::io_signature::make(0, 0, 0),
+                             gr::io_signature::make(1, 1, sizeof(gr_complex))),
+              d_encoder(samp_rate, bandwidth, sf, cr, crc, implicit, reduced_rate, preamble_len, sync_word),
+              d_gap(gap_symbols * d_encoder.samples_per_symbol()),
+              d_pending_read(0u),
+              d_frames(0u) {
+            d_payload.reserve(255u);
+            d_pending.reserve(d_encoder.frame_length(255u) + d_gap);
+
+            message_port_register_in(pmt::mp("frames"));
+            set_msg_handler(pmt::mp("frames"), boost::bind(&modulator_impl::handle, this, boost::placeholders::_1));
+        }
+
+        /**
+         * Our virtual destructor.
+         */
+        modulator_impl::~modulator_impl() {
+        }
+
+        /**
+         *  Accept a payload as a blob, a u8vector or a PDU.
+         */
+        void modulator_impl::handle(pmt::pmt_t msg) {
+            if (pmt::is_pair(msg))
+                msg = pmt::cdr(msg);
+
+            if (pmt::is_u8vector(msg)) {
+                size_t length;
+                const uint8_t* data = pmt::u8vector_elements(msg, length);
+                queue_frame(std::vector<uint8_t>(data, data + length));
+            } else if (pmt::is_blob(msg)) {
+                const uint8_t* data = (const uint8_t*)pmt::blob_data(msg);
+                queue_frame(std::vector<uint8_t>(data, data + pmt::blob_length(msg)));
+            } else {
+                std::cerr << "[LoRa Modulator] WARNING : Ignoring message that is not a byte vector." << std::endl;
+            }
+        }
+
+        void modulator_impl::queue_frame(const std::vector<uint8_t>& payload) {
+            if (payload.size() > 255u) {
+                std::cerr << "[LoRa Modulator] WARNING : Ignoring payload of " << payload.size() << " bytes, the maximum is 255." << std::endl;
+                return;
+            }
+
+            boost::mutex::scoped_lock lock(d_mutex);
+            d_queue.push_back(payload);
+        }
+
+        uint32_t modulator_impl::num_queued() {
+            boost::mutex::scoped_lock lock(d_mutex);
+            return d_queue.size();
+        }
+
+        uint64_t modulator_impl::num_frames() const {
+            return d_frames;
+        }
+
+        /**
+         *  Modulate the next queued payload into `d_pending` and tag its first sample, which is written at
+         *  `offset` in the current output buffer.
+         */
+        bool modulator_impl::next_frame(int offset) {
+            {
+                boost::mutex::scoped_lock lock(d_mutex);
+                if (d_queue.empty())
+                    return false;
+
+                d_payload.swap(d_queue.front());
+                d_queue.pop_front();
+            }
+
+            d_pending.clear();
+            d_pending_read = 0u;
+            d_encoder.modulate(d_payload.data(), d_payload.size(), d_pending);
+            d_pending.resize(d_pending.size() + d_gap, gr_complex(0.0f, 0.0f));
+
+            add_item_tag(0, nitems_written(0) + offset, pmt::mp("payload_len"), pmt::from_long(d_payload.size()));
+            d_frames++;
+
+            return true;
+        }
+
+        int modulator_impl::work(int noutput_items,
+                                 gr_vector_const_void_star& input_items,
+                                 gr_vector_void_star& output_items) {
+            gr_complex *out = (gr_complex *) output_items[0];
+            int produced = 0;
+
+            while (produced < noutput_items) {
+                if (d_pending_read == d_pending.size() && !next_frame(produced)) {
+                    // Idle: nothing queued
+                    std::fill(out + produced, out + noutput_items, gr_complex(0.0f, 0.0f));
+                    break;
+                }
+
+                const size_t n = std::min(d_pending.size() - d_pending_read, (size_t)(noutput_items - produced));
+                memcpy(out + produced, &d_pending[d_pending_read], sizeof(gr_complex) * n);
+                d_pending_read += n;
+                produced       += n;
+            }
+
+            return noutput_items;
+        }
+
+    } /* namespace lora */
+} /* namespace gr */
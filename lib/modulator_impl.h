@@ -0,0 +1,67 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LORA_MODULATOR_IMPL_H
+#define INCLUDED_LORA_MODULATOR_IMPL_H
+
+#include <lora/modulator.h>
+#include <lora/encoder.h>
+#include <boost/thread.hpp>
+#include <atomic>
+#include <deque>
+#include <vector>
+
+namespace gr {
+    namespace lora {
+
+        class modulator_impl : public modulator {
+            private:
+                encoder                          d_encoder;
+                const uint32_t                   d_gap;             ///< Zero samples after each frame.
+
+                std::deque<std::vector<uint8_t>> d_queue;           ///< Payloads waiting to be modulated.
+                boost::mutex                     d_mutex;           ///< Protects `d_queue`.
+
+                std::vector<uint8_t>             d_payload;         ///< Payload of the frame being sent.
+                std::vector<gr_complex>          d_pending;         ///< Samples of the frame being sent, including the gap. Keeps its capacity.
+                size_t                           d_pending_read;
+
+                std::atomic<uint64_t>            d_frames;
+
+                void handle(pmt::pmt_t msg);
+                bool next_frame(int offset);
+
+            public:
+                modulator_impl(float samp_rate, uint32_t bandwidth, uint8_t sf, uint8_t cr, bool crc, bool implicit, bool reduced_rate, uint16_t preamble_len, uint8_t sync_word, uint32_t gap_symbols);
+                ~modulator_impl();
+
+                void     queue_frame(const std::vector<uint8_t>& payload);
+                uint32_t num_queued();
+                uint64_t num_frames() const;
+
+                int work(int noutput_items,
+                         gr_vector_const_void_star& input_items,
+                         gr_vector_void_star& output_items);
+        };
+
+    } // namespace lora
+} // namespace gr
+
+#endif /* INCLUDED_LORA_MODULATOR_IMPL_H */
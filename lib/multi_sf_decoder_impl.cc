@@ -0,0 +1,151 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+    #include "config.h"
+#endif
+
+#include "multi_sf_decoder_impl.h"
+#include <algorithm>
+
+namespace gr {
+    namespace lora {
+
+        multi_sf_decoder::sptr multi_sf_decoder::make(float samp_rate, uint32_t bandwidth, const std::vector<uint8_t>& sfs, bool implicit, uint8_t cr, bool crc, bool reduced_rate, bool disable_drift_correction) {
+            return std::make_shared<multi_sf_decoder_impl>(samp_rate, bandwidth, sfs, implicit, cr, crc, reduced_rate, disable_drift_correction);
+        }
+
+        multi_sf_decoder_impl::multi_sf_decoder_impl(float samp_rate, uint32_t bandwidth, const std::vector<uint8_t>& sfs, bool implicit, uint8_t cr, bool crc, bool reduced_rate, bool disable_drift_correction)
+            : d_detector(samp_rate, bandwidth, sfs),
+              d_position(0u) {
+            for (size_t i = 0u; i < d_detector.num_lanes(); i++) {
+                d_decoders.push_back(std::make_shared<phy_decoder_impl>(samp_rate, bandwidth, d_detector.sf(i), implicit, cr, crc, reduced_rate, disable_drift_correction));
+                d_decoders.back()->set_shared_detection(true);
+            }
+        }
+
+        void multi_sf_decoder_impl::hand_off(void) {
+            for (size_t i = 0u; i < d_decoders.size(); i++) {
+                std::vector<preamble_hit_t>& hits = d_detector.hits(i);
+
+                for (const preamble_hit_t& hit : hits)
+                    d_decoders[i]->preamble_detected(hit);
+                hits.clear();
+
+                d_decoders[i]->set_detection_frontier(d_detector.frontier(i));
+            }
+        }
+
+        void multi_sf_decoder_impl::sort_frames(std::vector<frame_sptr>& frames) {
+            std::stable_sort(frames.begin(), frames.end(), [](const frame_sptr& a, const frame_sptr& b) {
+                return a->timing().publish_sample < b->timing().publish_sample;
+            });
+        }
+
+        /**
+         *  The detector goes first. A decoder steps in `DecoderState::DETECT` only where it has two symbols of
+         *  input, which is exactly where the detector has tested the windows of its SF. As in
+         *  `phy_decoder_impl::process`, steps that start in the kept samples run on a copy extended with the
+         *  start of this block, all others straight from the caller's buffer.
+         */
+        std::vector<frame_sptr> multi_sf_decoder_impl::process(const gr_complex* samples, size_t length) {
+            std::vector<frame_sptr> frames;
+            const uint64_t origin       = d_position;
+            const uint64_t carry_origin = origin - d_carry.size();
+
+            d_detector.process(samples, length);
+            hand_off();
+
+            if (!d_carry.empty())
+                d_carry.insert(d_carry.end(), samples, samples + std::min(length, (size_t)lookahead()));
+
+            uint64_t earliest = origin + length;
+            for (std::shared_ptr<phy_decoder_impl>& decoder : d_decoders) {
+                if (!d_carry.empty() && decoder->position() < origin) {
+                    const size_t offset = decoder->position() - carry_origin;
+                    decoder->run(&d_carry[offset], d_carry.size() - offset, origin, frames);
+                }
+
+                // Still in the kept samples only when the whole block went into them
+                if (decoder->position() >= origin)
+                    decoder->run(samples + (decoder->position() - origin), length - (decoder->position() - origin), UINT64_MAX, frames);
+
+                earliest = std::min(earliest, decoder->position());
+            }
+
+            d_position = origin + length;
+            if (earliest < origin)
+                d_carry.erase(d_carry.begin(), d_carry.begin() + (earliest - carry_origin));
+            else
+                d_carry.assign(samples + (earliest - origin), samples + length);
+
+            sort_frames(frames);
+            return frames;
+        }
+
+        std::vector<frame_sptr> multi_sf_decoder_impl::flush(void) {
+            std::vector<frame_sptr> frames;
+            const uint64_t carry_origin = d_position - d_carry.size();
+
+            d_detector.flush();
+            hand_off();
+
+            // Steps may look up to two symbols past the last kept sample, into the padding, but start before it
+            d_carry.resize(d_carry.size() + lookahead(), gr_complex(0.0f, 0.0f));
+            for (std::shared_ptr<phy_decoder_impl>& decoder : d_decoders) {
+                const size_t offset = decoder->position() - carry_origin;
+
+                decoder->set_detection_frontier(UINT64_MAX);
+                decoder->run(&d_carry[offset], d_carry.size() - offset, d_position, frames);
+            }
+
+            sort_frames(frames);
+            reset();
+            return frames;
+        }
+
+        void multi_sf_decoder_impl::reset(void) {
+            d_detector.reset();
+            d_carry.clear();
+            d_position = 0u;
+
+            for (std::shared_ptr<phy_decoder_impl>& decoder : d_decoders)
+                decoder->reset();
+        }
+
+        std::vector<uint8_t> multi_sf_decoder_impl::sfs(void) const {
+            std::vector<uint8_t> result;
+
+            for (const std::shared_ptr<phy_decoder_impl>& decoder : d_decoders)
+                result.push_back(decoder->sf());
+
+            return result;
+        }
+
+        phy_decoder::sptr multi_sf_decoder_impl::decoder(uint8_t sf) {
+            for (std::shared_ptr<phy_decoder_impl>& decoder : d_decoders) {
+                if (decoder->sf() == sf)
+                    return decoder;
+            }
+
+            return phy_decoder::sptr();
+        }
+    } // namespace lora
+} // namespace gr
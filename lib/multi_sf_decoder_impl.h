@@ -0,0 +1,73 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LORA_MULTI_SF_DECODER_IMPL_H
+#define INCLUDED_LORA_MULTI_SF_DECODER_IMPL_H
+
+#include <lora/multi_sf_decoder.h>
+#include "phy_decoder_impl.h"
+#include "preamble_detector.h"
+#include <memory>
+#include <vector>
+
+namespace gr {
+    namespace lora {
+
+        /**
+         *  \brief  A `preamble_detector` feeding one `phy_decoder_impl` per SF, in shared detection mode.
+         *          <br/>Before each block, every decoder gets the hits of its SF and the position up to which the
+         *          detector has looked. The decoders then run over the same input, with one set of kept samples
+         *          for all of them instead of a copy each.
+         */
+        class multi_sf_decoder_impl : public multi_sf_decoder {
+            private:
+                preamble_detector d_detector;                               ///< The detection pass shared by all SFs.
+                std::vector<std::shared_ptr<phy_decoder_impl>> d_decoders;  ///< One per lane of `d_detector`, in the same order.
+                std::vector<gr_complex> d_carry;                            ///< Samples from the position of the lagging decoder on.
+                uint64_t                d_position;                         ///< Samples received since construction or `reset`.
+
+                /**
+                 *  \brief  Hand the new hits of every SF to its decoder, with the position the detector has covered.
+                 */
+                void hand_off(void);
+
+                /**
+                 *  \brief  Order the frames of all SFs by the input position at which they completed.
+                 */
+                static void sort_frames(std::vector<frame_sptr>& frames);
+
+            public:
+                multi_sf_decoder_impl(float samp_rate, uint32_t bandwidth, const std::vector<uint8_t>& sfs, bool implicit, uint8_t cr, bool crc, bool reduced_rate, bool disable_drift_correction);
+
+                std::vector<frame_sptr> process(const gr_complex* samples, size_t length);
+                std::vector<frame_sptr> flush(void);
+                void reset(void);
+
+                uint32_t lookahead(void) const              { return d_detector.lookahead(); }
+                std::vector<uint8_t> sfs(void) const;
+                phy_decoder::sptr decoder(uint8_t sf);
+
+                uint64_t num_windows(void)                  { return d_detector.num_windows(); }
+                uint64_t num_harmonic_rejects(void)         { return d_detector.num_harmonic_rejects(); }
+        };
+    } // namespace lora
+} // namespace gr
+
+#endif /* INCLUDED_LORA_MULTI_SF_DECODER_IMPL_H */
@@ -0,0 +1,1564 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017 Pieter Robyns, William Thenaers.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ * 2018: patches by wilfried.philips@wphilipe.eu for low data rate and implicit header decoding
+ */
+
+#ifdef HAVE_CONFIG_H
+    #include "config.h"
+#endif
+
+#include <gnuradio/expj.h>
+#include <liquid/liquid.h>
+#include <numeric>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif
+#include <lora/latency.h>
+#include <lora/loratap.h>
+#include <lora/utilities.h>
+#include "phy_decoder_impl.h"
+#include "tables.h"
+
+#include "logger.h"
+
+namespace gr {
+    namespace lora {
+
+        /**
+         *  Counters have a single writer, so a relaxed load and store is enough and avoids a locked add.
+         */
+        static inline void add(std::atomic<uint64_t>& counter, const uint64_t value) {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        static inline void increment(std::atomic<uint64_t>& counter) {
+            add(counter, 1u);
+        }
+
+        phy_decoder::sptr phy_decoder::make(float samp_rate, uint32_t bandwidth, uint8_t sf, bool implicit, uint8_t cr, bool crc, bool reduced_rate, bool disable_drift_correction) {
+            return std::make_shared<phy_decoder_impl>(samp_rate, bandwidth, sf, implicit, cr, crc, reduced_rate, disable_drift_correction);
+        }
+
+        /**
+         * The private constructor
+         */
+        phy_decoder_impl::phy_decoder_impl(float samp_rate, uint32_t bandwidth, uint8_t sf, bool implicit, uint8_t cr, bool crc, bool reduced_rate, bool disable_drift_correction)
+            : d_ctx(&d_acquisition), d_pwr_queue(MAX_PWR_QUEUE_SIZE) {
+            // Radio config
+            d_acquisition.state = gr::lora::DecoderState::DETECT;
+
+            if (sf < 6 || sf > 12)
+                throw std::invalid_argument("[LoRa Decoder] Spreading factor should be between 6 and 12 (inclusive)");
+
+            #ifdef GRLORA_DEBUG
+                d_debug_samples.open("/tmp/grlora_debug", std::ios::out | std::ios::binary);
+                d_dbg.attach();
+            #endif
+
+            d_bw                 = bandwidth;
+            memset(&d_config_phdr, 0, sizeof(loraphy_header_t));
+            d_config_phdr.cr          = cr;
+            d_config_phdr.has_mac_crc = crc;
+            d_config_implicit     = implicit;
+            d_config_reduced_rate = reduced_rate;
+            d_autodetect          = false;
+            d_samples_per_second = samp_rate;
+            d_dt                 = 1.0f / d_samples_per_second;
+            d_sf                 = sf;
+            d_bits_per_second    = (double)d_sf * (double)(4.0 / (4.0 + d_config_phdr.cr)) / (1u << d_sf) * d_bw;
+            d_symbols_per_second = (double)d_bw / (1u << d_sf);
+            d_period             = 1.0f / (double)d_symbols_per_second;
+            d_bits_per_symbol    = (double)(d_bits_per_second    / d_symbols_per_second);
+            d_samples_per_symbol = (uint32_t)(d_samples_per_second / d_symbols_per_second);
+            d_delay_after_sync   = d_samples_per_symbol / 4u;
+            d_number_of_bins     = (uint32_t)(1u << d_sf);
+            d_number_of_bins_hdr = (uint32_t)(1u << (d_sf-2));
+            d_decim_factor       = d_samples_per_symbol / d_number_of_bins;
+            d_enable_fine_sync = !disable_drift_correction;
+            d_position = 0u;
+            d_estimate_cfo = false;
+            d_drop_invalid = false;
+            d_sync_bins[0] = d_sync_bins[1] = 0u;
+            d_dual_polarity = false;
+            d_shared_detection = false;
+            d_shared_frontier  = 0u;
+            d_noise_power      = -1.0f;
+            d_frame_end        = 0u;
+            d_time_ref_sample  = 0u;
+            d_time_ref_ns      = 0u;
+            set_sync_words(std::vector<uint8_t>());
+
+            d_acquisition.position           = 0u;
+            d_acquisition.implicit           = implicit;
+            d_acquisition.reduced_rate       = reduced_rate;
+            d_acquisition.infer_header       = false;
+            d_acquisition.infer_reduced_rate = false;
+            d_acquisition.phdr               = d_config_phdr;
+            d_acquisition.mac_crc            = 0u;
+            d_acquisition.crc                = crc_status::NONE;
+            d_acquisition.sync_word          = 0u;
+            d_acquisition.inverted           = false;
+            d_acquisition.payload_symbols    = 0;
+            d_acquisition.payload_length     = 0u;
+            d_acquisition.symbol_quality     = 0.0f;
+            d_acquisition.weak_symbols       = 0u;
+            d_acquisition.weak_start         = 0u;
+            d_acquisition.energy_threshold   = 0.0f;
+            d_acquisition.snr                = std::numeric_limits<float>::quiet_NaN();
+            d_acquisition.cfo_estimation     = 0.0f;
+            d_acquisition.fine_sync          = 0;
+            d_acquisition.timing             = frame_timing_t();
+
+            GRLORA_LOG(DEMOD, DEBUG, "SF {}: {} bits (nominal) and {} bins per symbol, {} samples per symbol, decimation {}",
+                       (int)d_sf, d_bits_per_symbol, d_number_of_bins, d_samples_per_symbol, d_decim_factor);
+            if(!d_enable_fine_sync)
+                GRLORA_LOG(DEMOD, INFO, "SF {}: clock drift correction disabled", (int)d_sf);
+            if(d_config_implicit)
+                GRLORA_LOG(DECODE, DEBUG, "SF {}: implicit header, CR {}, CRC {}", (int)d_sf, (int)d_config_phdr.cr, (int)d_config_phdr.has_mac_crc);
+
+            // Locally generated chirps
+            build_ideal_chirps();
+
+            // FFT decoding preparations
+            d_fft.resize(d_samples_per_symbol);
+            d_mult_hf.resize(d_samples_per_symbol);
+            d_tmp.resize(d_number_of_bins);
+            d_q  = fft_create_plan(d_samples_per_symbol, &d_mult_hf[0], &d_fft[0],     LIQUID_FFT_FORWARD, 0);
+            d_qr = fft_create_plan(d_number_of_bins,     &d_tmp[0],     &d_mult_hf[0], LIQUID_FFT_BACKWARD, 0);
+
+            // Hamming coding
+            fec_scheme fs = LIQUID_FEC_HAMMING84;
+            d_h48_fec = fec_create(fs, NULL);
+
+            // Output frames, preallocated at the maximum PHY payload size
+            d_frame_pool = frame_pool::make(DECODER_FRAME_POOL_SIZE);
+            d_acquisition.decoded.reserve(LORA_FRAME_MAX_PAYLOAD);
+            d_acquisition.header_block.reserve(d_sf);
+
+            // Packet contexts start out free, with their buffers reserved like those of `d_acquisition`
+            d_packets.resize(DECODER_PACKET_CONTEXTS, d_acquisition);
+            for (packet_context_t& ctx : d_packets) {
+                ctx.decoded.reserve(LORA_FRAME_MAX_PAYLOAD);
+                ctx.header_block.reserve(d_sf);
+            }
+
+            clear_counters();
+            d_counters_origin = 0u;
+            d_reset_counters  = false;
+        }
+
+        /**
+         * Our virtual destructor.
+         */
+        phy_decoder_impl::~phy_decoder_impl() {
+            #ifdef GRLORA_DEBUG
+                if (d_debug_samples.is_open())
+                    d_debug_samples.close();
+            #endif
+
+            fft_destroy_plan(d_q);
+            fft_destroy_plan(d_qr);
+            fec_destroy(d_h48_fec);
+        }
+
+        void phy_decoder_impl::build_ideal_chirps(void) {
+            d_downchirp.resize(d_samples_per_symbol);
+            d_upchirp.resize(d_samples_per_symbol);
+            d_downchirp_ifreq.resize(d_samples_per_symbol);
+            d_upchirp_ifreq.resize(d_samples_per_symbol);
+            d_upchirp_ifreq_v.resize(d_samples_per_symbol*3);
+            gr_complex tmp[d_samples_per_symbol*3];
+
+            const double T       = -0.5 * d_bw * d_symbols_per_second;
+            const double f0      = (d_bw / 2.0);
+            const double pre_dir = 2.0 * M_PI;
+            double t;
+            gr_complex cmx       = gr_complex(1.0f, 1.0f);
+
+            for (uint32_t i = 0u; i < d_samples_per_symbol; i++) {
+                // Width in number of samples = samples_per_symbol
+                // See https://en.wikipedia.org/wiki/Chirp#Linear
+                t = d_dt * i;
+                d_downchirp[i] = cmx * gr_expj(pre_dir * t * (f0 + T * t));
+                d_upchirp[i]   = cmx * gr_expj(pre_dir * t * (f0 + T * t) * -1.0f);
+            }
+
+            // Store instantaneous frequency
+            instantaneous_frequency(&d_downchirp[0], &d_downchirp_ifreq[0], d_samples_per_symbol);
+            instantaneous_frequency(&d_upchirp[0],   &d_upchirp_ifreq[0],   d_samples_per_symbol);
+
+            // Statistics of the downchirp over the window correlated in FIND_SFD
+            const uint32_t window = d_samples_per_symbol - 1u;
+            const float mean = std::accumulate(&d_downchirp_ifreq[0], &d_downchirp_ifreq[window], 0.0f) / (float)window;
+            d_downchirp_ifreq_centered.resize(window);
+            d_downchirp_ifreq_energy = 0.0f;
+            for (uint32_t i = 0u; i < window; i++) {
+                d_downchirp_ifreq_centered[i] = d_downchirp_ifreq[i] - mean;
+                d_downchirp_ifreq_energy     += d_downchirp_ifreq_centered[i] * d_downchirp_ifreq_centered[i];
+            }
+
+            samples_to_file("/tmp/downchirp", &d_downchirp[0], d_downchirp.size(), sizeof(gr_complex));
+            samples_to_file("/tmp/upchirp",   &d_upchirp[0],   d_upchirp.size(),   sizeof(gr_complex));
+
+            // Upchirp sequence
+            memcpy(tmp, &d_upchirp[0], sizeof(gr_complex) * d_samples_per_symbol);
+            memcpy(tmp+d_samples_per_symbol, &d_upchirp[0], sizeof(gr_complex) * d_samples_per_symbol);
+            memcpy(tmp+d_samples_per_symbol*2, &d_upchirp[0], sizeof(gr_complex) * d_samples_per_symbol);
+            instantaneous_frequency(tmp, &d_upchirp_ifreq_v[0], d_samples_per_symbol*3);
+
+            // Every window of one symbol covers a full period, so all of them share the mean and energy of the middle one
+            const float upchirp_mean = std::accumulate(&d_upchirp_ifreq_v[d_samples_per_symbol], &d_upchirp_ifreq_v[2u * d_samples_per_symbol], 0.0f) / (float)d_samples_per_symbol;
+            d_upchirp_ifreq_v_centered.resize(d_upchirp_ifreq_v.size());
+            d_upchirp_ifreq_energy = 0.0f;
+            for (uint32_t i = 0u; i < d_upchirp_ifreq_v.size(); i++)
+                d_upchirp_ifreq_v_centered[i] = d_upchirp_ifreq_v[i] - upchirp_mean;
+            for (uint32_t i = d_samples_per_symbol; i < 2u * d_samples_per_symbol; i++)
+                d_upchirp_ifreq_energy += d_upchirp_ifreq_v_centered[i] * d_upchirp_ifreq_v_centered[i];
+        }
+
+        void phy_decoder_impl::samples_to_file(const std::string path, const gr_complex *v, const uint32_t length, const uint32_t elem_size) {
+            #ifdef GRLORA_DEBUG
+                std::ofstream out_file;
+                out_file.open(path.c_str(), std::ios::out | std::ios::binary);
+
+                //for(std::vector<gr_complex>::const_iterator it = v.begin(); it != v.end(); ++it) {
+                for (uint32_t i = 0u; i < length; i++) {
+                    out_file.write(reinterpret_cast<const char *>(&v[i]), elem_size);
+                }
+
+                out_file.close();
+            #else
+                (void) path;
+                (void) v;
+                (void) length;
+                (void) elem_size;
+            #endif
+        }
+
+        void phy_decoder_impl::samples_debug(const gr_complex *v, const uint32_t length) {
+            #ifdef GRLORA_DEBUG
+                gr_complex start_indicator(0.0f, 32.0f);
+                d_debug_samples.write(reinterpret_cast<const char *>(&start_indicator), sizeof(gr_complex));
+
+                for (uint32_t i = 1u; i < length; i++) {
+                    d_debug_samples.write(reinterpret_cast<const char *>(&v[i]), sizeof(gr_complex));
+                }
+            #else
+                (void) v;
+                (void) length;
+            #endif
+        }
+
+        void phy_decoder_impl::instantaneous_frequency(const gr_complex *in_samples, float *out_ifreq, const uint32_t window) {
+            if (window < 2u) {
+                std::cerr << "[LoRa Decoder] WARNING : window size < 2 !" << std::endl;
+                return;
+            }
+
+            /* instantaneous_phase */
+            for (uint32_t i = 1u; i < window; i++) {
+                const float iphase_1 = std::arg(in_samples[i - 1]);
+                      float iphase_2 = std::arg(in_samples[i]);
+
+                // Unwrapped loops from liquid_unwrap_phase
+                while ( (iphase_2 - iphase_1) >  M_PI ) iphase_2 -= 2.0f*M_PI;
+                while ( (iphase_2 - iphase_1) < -M_PI ) iphase_2 += 2.0f*M_PI;
+
+                out_ifreq[i - 1] = iphase_2 - iphase_1;
+            }
+
+            // Make sure there is no strong gradient if this value is accessed by mistake
+            out_ifreq[window - 1] = out_ifreq[window - 2];
+        }
+
+        void phy_decoder_impl::received_frequency(const gr_complex *in_samples, float *out_ifreq, const uint32_t window) {
+            instantaneous_frequency(in_samples, out_ifreq, window);
+
+            if (d_ctx->inverted)
+                volk_32f_s32f_multiply_32f(out_ifreq, out_ifreq, -1.0f, window);
+        }
+
+        inline void phy_decoder_impl::instantaneous_phase(const gr_complex *in_samples, float *out_iphase, const uint32_t window) {
+            out_iphase[0] = std::arg(in_samples[0]);
+
+            for (uint32_t i = 1u; i < window; i++) {
+                out_iphase[i] = std::arg(in_samples[i]);
+                // = the same as atan2(imag(in_samples[i]),real(in_samples[i]));
+
+                // Unwrapped loops from liquid_unwrap_phase
+                while ( (out_iphase[i] - out_iphase[i-1]) >  M_PI ) out_iphase[i] -= 2.0f*M_PI;
+                while ( (out_iphase[i] - out_iphase[i-1]) < -M_PI ) out_iphase[i] += 2.0f*M_PI;
+            }
+        }
+
+        float phy_decoder_impl::cross_correlate_ifreq_fast(const float *samples_ifreq, const float *ideal_chirp, const uint32_t window) {
+            float result = 0;
+            volk_32f_x2_dot_prod_32f(&result, samples_ifreq, ideal_chirp, window);
+            return result;
+        }
+
+        float phy_decoder_impl::cross_correlate_fast(const gr_complex *samples, const gr_complex *ideal_chirp, const uint32_t window) {
+            gr_complex result = 0;
+            volk_32fc_x2_conjugate_dot_prod_32fc(&result, samples, ideal_chirp, window);
+            return abs(result);
+        }
+
+        float phy_decoder_impl::cross_correlate(const gr_complex *samples_1, const gr_complex *samples_2, const uint32_t window) {
+            float result = 0.0f;
+
+            for (uint32_t i = 0u; i < window; i++) {
+                result += std::real(samples_1[i] * std::conj(samples_2[i]));
+            }
+
+            result /= (float)window;
+
+            return result;
+        }
+
+        float phy_decoder_impl::cross_correlate_ifreq(const float *samples_ifreq, const std::vector<float>& ideal_chirp, const uint32_t to_idx) {
+            float result = 0.0f;
+
+            const float average   = std::accumulate(samples_ifreq  , samples_ifreq + to_idx, 0.0f) / (float)(to_idx);
+            const float chirp_avg = std::accumulate(&ideal_chirp[0], &ideal_chirp[to_idx]  , 0.0f) / (float)(to_idx);
+            const float sd        =   stddev(samples_ifreq   , to_idx, average)
+                                    * stddev(&ideal_chirp[0] , to_idx, chirp_avg);
+
+            for (uint32_t i = 0u; i < to_idx; i++) {
+                result += (samples_ifreq[i] - average) * (ideal_chirp[i] - chirp_avg) / sd;
+            }
+
+            result /= (float)(to_idx);
+
+            return result;
+        }
+
+        void phy_decoder_impl::fine_sync(const gr_complex* in_samples, int32_t bin_idx, int32_t search_space) {
+            int32_t shift_ref = ((bin_idx+1) % d_number_of_bins) * d_decim_factor;
+            float samples_ifreq[d_samples_per_symbol];
+            float max_correlation = 0.0f;
+            int32_t lag = 0;
+
+            received_frequency(in_samples, samples_ifreq, d_samples_per_symbol);
+
+            for(int32_t i = -search_space+1; i < search_space; i++) {
+                //float c = cross_correlate_fast(in_samples, &d_upchirp_v[shift_ref+i+d_samples_per_symbol], d_samples_per_symbol);
+                float c = cross_correlate_ifreq_fast(samples_ifreq, &d_upchirp_ifreq_v[shift_ref+i+d_samples_per_symbol], d_samples_per_symbol);
+                if(c > max_correlation) {
+                     max_correlation = c;
+                     lag = i;
+                 }
+            }
+
+            GRLORA_LOG(SYNC, TRACE, "LAG : {}", lag);
+
+            d_ctx->fine_sync = -lag;
+
+            // Soft limit impact of correction
+            /*
+            if(lag > 0)
+                d_ctx->fine_sync = std::min(-lag / 2, -1);
+            else if(lag < 0)
+                d_ctx->fine_sync = std::max(-lag / 2, 1);*/
+
+            // Hard limit impact of correction
+            /*if(abs(d_ctx->fine_sync) >= d_decim_factor / 2)
+                d_ctx->fine_sync = 0;*/
+
+            //d_ctx->fine_sync = 0;
+            GRLORA_LOG(SYNC, TRACE, "FINE: {}", d_ctx->fine_sync);
+        }
+
+        /**
+         *  Early-late gate on the correlation of the instantaneous frequency with the ideal chirp of the
+         *  demodulated bin. Clock drift moves the peak by much less than a sample per symbol, so starting
+         *  from the current alignment it takes three dot products, plus one per sample the peak moved,
+         *  where `fine_sync` evaluates every lag of the search space.
+         */
+        void phy_decoder_impl::track_timing(const float *samples_ifreq, int32_t bin_idx, int32_t search_space) {
+            const float* ref = &d_upchirp_ifreq_v[((bin_idx+1) % d_number_of_bins) * d_decim_factor + d_samples_per_symbol];
+            int32_t lag = 0;
+
+            float prompt = cross_correlate_ifreq_fast(samples_ifreq, ref,      d_samples_per_symbol);
+            float early  = cross_correlate_ifreq_fast(samples_ifreq, ref - 1,  d_samples_per_symbol);
+            float late   = cross_correlate_ifreq_fast(samples_ifreq, ref + 1,  d_samples_per_symbol);
+
+            // Follow the gate towards the peak, within the same lags as `fine_sync`
+            while (late > prompt && lag + 1 < search_space) {
+                lag++;
+                early  = prompt;
+                prompt = late;
+                late   = cross_correlate_ifreq_fast(samples_ifreq, ref + lag + 1, d_samples_per_symbol);
+            }
+            while (early > prompt && lag - 1 > -search_space) {
+                lag--;
+                late   = prompt;
+                prompt = early;
+                early  = cross_correlate_ifreq_fast(samples_ifreq, ref + lag - 1, d_samples_per_symbol);
+            }
+
+            // Like `fine_sync`, only trust a positive correlation
+            d_ctx->fine_sync = prompt > 0.0f ? -lag : 0;
+
+            GRLORA_LOG(SYNC, TRACE, "TRACK: {}", d_ctx->fine_sync);
+        }
+
+        /**
+         *  Same coefficient as `cross_correlate_ifreq`, in one pass. As the reference has zero mean, the
+         *  sample mean drops out of the numerator, and the sample variance follows from the sums of the
+         *  samples and of their squares, accumulated together with the dot product.
+         */
+        float phy_decoder_impl::cross_correlate_ifreq_centered(const float *samples_ifreq, const float *ideal_centered, const float ideal_energy, const uint32_t window) {
+            float sum = 0.0f, sum_sq = 0.0f, dot = 0.0f;
+            uint32_t i = 0u;
+
+            #if defined(__SSE__)
+                __m128 v_sum = _mm_setzero_ps(), v_sum_sq = _mm_setzero_ps(), v_dot = _mm_setzero_ps();
+                float lanes[4];
+
+                for (; i + 4u <= window; i += 4u) {
+                    const __m128 x = _mm_loadu_ps(samples_ifreq + i);
+                    v_sum    = _mm_add_ps(v_sum,    x);
+                    v_sum_sq = _mm_add_ps(v_sum_sq, _mm_mul_ps(x, x));
+                    v_dot    = _mm_add_ps(v_dot,    _mm_mul_ps(x, _mm_loadu_ps(ideal_centered + i)));
+                }
+
+                _mm_storeu_ps(lanes, v_sum);    sum    = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+                _mm_storeu_ps(lanes, v_sum_sq); sum_sq = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+                _mm_storeu_ps(lanes, v_dot);    dot    = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+            #endif
+
+            for (; i < window; i++) {
+                sum    += samples_ifreq[i];
+                sum_sq += samples_ifreq[i] * samples_ifreq[i];
+                dot    += samples_ifreq[i] * ideal_centered[i];
+            }
+
+            const float energy = (sum_sq - sum * sum / (float)window) * ideal_energy;
+
+            // A constant input has no defined correlation
+            return energy > 0.0f ? dot / std::sqrt(energy) : 0.0f;
+        }
+
+        float phy_decoder_impl::detect_preamble_autocorr(const gr_complex *samples, const uint32_t window) {
+            const gr_complex* chirp1 = samples;
+            const gr_complex* chirp2 = samples + d_samples_per_symbol;
+            float magsq_chirp1[window];
+            float magsq_chirp2[window];
+            float energy_chirp1 = 0;
+            float energy_chirp2 = 0;
+            float autocorr = 0;
+            gr_complex dot_product;
+
+            volk_32fc_x2_conjugate_dot_prod_32fc(&dot_product, chirp1, chirp2, window);
+            volk_32fc_magnitude_squared_32f(magsq_chirp1, chirp1, window);
+            volk_32fc_magnitude_squared_32f(magsq_chirp2, chirp2, window);
+            volk_32f_accumulator_s32f(&energy_chirp1, magsq_chirp1, window);
+            volk_32f_accumulator_s32f(&energy_chirp2, magsq_chirp2, window);
+
+            // When using implicit mode, stop when energy is halved.
+            d_ctx->energy_threshold = energy_chirp2 / 2.0f;
+
+            // For calculating the SNR later on
+            d_pwr_queue.push_back(energy_chirp1 / d_samples_per_symbol);
+
+            // Autocorr value
+            autocorr = abs(dot_product / gr_complex(sqrt(energy_chirp1 * energy_chirp2), 0));
+
+            return autocorr;
+        }
+
+        float phy_decoder_impl::determine_energy(const gr_complex *samples) {
+            float magsq_chirp[d_samples_per_symbol];
+            float energy_chirp = 0;
+            volk_32fc_magnitude_squared_32f(magsq_chirp, samples, d_samples_per_symbol);
+            volk_32f_accumulator_s32f(&energy_chirp, magsq_chirp, d_samples_per_symbol);
+
+            return energy_chirp;
+        }
+
+        void phy_decoder_impl::determine_snr() {
+            // Never the SNR of an earlier frame
+            d_ctx->snr = std::numeric_limits<float>::quiet_NaN();
+
+            if(d_noise_power >= 0.0f && !d_pwr_queue.empty()) {
+                float pwr_signal = d_pwr_queue[d_pwr_queue.size()-1];
+                d_ctx->snr = pwr_signal / d_noise_power;
+            }
+        }
+
+        float phy_decoder_impl::detect_downchirp(const gr_complex *samples, const uint32_t window) {
+            float samples_ifreq[window];
+            received_frequency(samples, samples_ifreq, window);
+
+            return detect_downchirp(samples_ifreq, window);
+        }
+
+        float phy_decoder_impl::detect_downchirp(const float *samples_ifreq, const uint32_t window) {
+            return cross_correlate_ifreq_centered(samples_ifreq, &d_downchirp_ifreq_centered[0], d_downchirp_ifreq_energy, window - 1u);
+        }
+
+        /**
+         *  A nibble `n` is sent as a chirp shifted by `8 n` chips, which demodulates to bin `8 n - 1`.
+         *  Rounding absorbs one bin of timing error either way.
+         */
+        uint8_t phy_decoder_impl::sync_word_from_bins(void) const {
+            const uint8_t hi = (uint8_t)std::lround((d_sync_bins[0] + 1u) / 8.0f) & 0x0fu;
+            const uint8_t lo = (uint8_t)std::lround((d_sync_bins[1] + 1u) / 8.0f) & 0x0fu;
+
+            return (uint8_t)((hi << 4u) | lo);
+        }
+
+        void phy_decoder_impl::set_sync_words(const std::vector<uint8_t>& sync_words) {
+            uint64_t filter[4] = { 0u, 0u, 0u, 0u };
+
+            for (const uint8_t w : sync_words)
+                filter[w >> 6u] |= 1ull << (w & 0x3fu);
+
+            for (uint32_t i = 0u; i < 4u; i++)
+                d_sync_word_filter[i].store(sync_words.empty() ? ~0ull : filter[i], std::memory_order_relaxed);
+        }
+
+        bool phy_decoder_impl::sync_word_accepted(const uint8_t sync_word) const {
+            return (d_sync_word_filter[sync_word >> 6u].load(std::memory_order_relaxed) >> (sync_word & 0x3fu)) & 1u;
+        }
+
+        float phy_decoder_impl::detect_upchirp(const gr_complex *samples, const uint32_t window, int32_t *index) {
+            float samples_ifreq[window*2];
+            instantaneous_frequency(samples, samples_ifreq, window*2);
+
+            d_ctx->inverted = false;
+            float correlation = sliding_norm_cross_correlate_upchirp(samples_ifreq, window, index);
+
+            // Inverted IQ mirrors the frequency track, so the same ideal upchirp serves both polarities
+            if (d_dual_polarity.load(std::memory_order_relaxed)) {
+                int32_t inverted_index = 0;
+                volk_32f_s32f_multiply_32f(samples_ifreq, samples_ifreq, -1.0f, window*2);
+
+                const float inverted_correlation = sliding_norm_cross_correlate_upchirp(samples_ifreq, window, &inverted_index);
+                if (inverted_correlation > correlation) {
+                    d_ctx->inverted  = true;
+                    *index      = inverted_index;
+                    correlation = inverted_correlation;
+                }
+            }
+
+            return correlation;
+        }
+
+        float phy_decoder_impl::sliding_norm_cross_correlate_upchirp(const float *samples_ifreq, const uint32_t window, int32_t *index) {
+             float max_correlation = 0;
+
+             // Cross correlate
+             for (uint32_t i = 0; i < window; i++) {
+                 const float max_corr = cross_correlate_ifreq_fast(samples_ifreq + i, &d_upchirp_ifreq[0], window - 1u);
+
+                 if (max_corr > max_correlation) {
+                     *index = i;
+                     max_correlation = max_corr;
+                 }
+             }
+
+             return max_correlation;
+         }
+
+        float phy_decoder_impl::stddev(const float *values, const uint32_t len, const float mean) {
+            float variance = 0.0f;
+
+            for (uint32_t i = 0u; i < len; i++) {
+                const float temp = values[i] - mean;
+                variance += temp * temp;
+            }
+
+            variance /= (float)len;
+            return std::sqrt(variance);
+        }
+
+        /**
+         *  Currently unstable due to center frequency offset.
+         */
+        uint32_t phy_decoder_impl::get_shift_fft(const gr_complex *samples) {
+            float fft_mag[d_number_of_bins];
+
+            samples_to_file("/tmp/data", &samples[0], d_samples_per_symbol, sizeof(gr_complex));
+
+            // Multiply with ideal downchirp
+            for (uint32_t i = 0u; i < d_samples_per_symbol; i++) {
+                d_mult_hf[i] = samples[i] * d_downchirp[i];
+            }
+
+            samples_to_file("/tmp/mult", &d_mult_hf[0], d_samples_per_symbol, sizeof(gr_complex));
+
+            // Perform FFT
+            fft_execute(d_q);
+
+            // Decimate. Note: assumes fft size is multiple of decimation factor and number of bins is even
+            // This decimation should be identical to numpy's approach
+            const uint32_t N = d_number_of_bins;
+            memcpy(&d_tmp[0],               &d_fft[0],                                     (N + 1u) / 2u * sizeof(gr_complex));
+            memcpy(&d_tmp[ (N + 1u) / 2u ], &d_fft[d_samples_per_symbol - (N / 2u)],        N / 2u * sizeof(gr_complex));
+            d_tmp[N / 2u] += d_fft[N / 2u];
+
+            // Get magnitude
+            for (uint32_t i = 0u; i < d_number_of_bins; i++) {
+                fft_mag[i] = std::abs(d_tmp[i]);
+            }
+
+            samples_to_file("/tmp/fft", &d_tmp[0], d_number_of_bins, sizeof(gr_complex));
+
+            fft_execute(d_qr); // For debugging
+            samples_to_file("/tmp/resampled", &d_mult_hf[0], d_number_of_bins, sizeof(gr_complex));
+
+            // Return argmax here
+            return (std::max_element(fft_mag, fft_mag + d_number_of_bins) - fft_mag);
+        }
+
+        uint32_t phy_decoder_impl::max_frequency_gradient_idx(const gr_complex *samples) {
+            float samples_ifreq[d_samples_per_symbol];
+
+            samples_to_file("/tmp/data", &samples[0], d_samples_per_symbol, sizeof(gr_complex));
+
+            received_frequency(samples, samples_ifreq, d_samples_per_symbol);
+
+            return max_frequency_gradient_idx(samples_ifreq);
+        }
+
+        uint32_t phy_decoder_impl::max_frequency_gradient_idx(const float *samples_ifreq) {
+            float samples_ifreq_avg[d_number_of_bins];
+
+            for(uint32_t i = 0; i < d_number_of_bins; i++) {
+                volk_32f_accumulator_s32f(&samples_ifreq_avg[i], &samples_ifreq[i*d_decim_factor], d_decim_factor);
+                samples_ifreq_avg[i] /= d_decim_factor;
+            }
+
+            float max_gradient = 0.1f;
+            float gradient = 0.0f;
+            uint32_t max_index = 0;
+            for (uint32_t i = 1u; i < d_number_of_bins; i++) {
+                gradient = samples_ifreq_avg[i - 1] - samples_ifreq_avg[i];
+                if (gradient > max_gradient) {
+                    max_gradient = gradient;
+                    max_index = i+1;
+                }
+            }
+
+            // A chirp shifted by k chips demodulates to bin k - 1; an unshifted one has no wrap at all
+            if (max_index == 0u)
+                return d_number_of_bins - 1u;
+
+            return (d_number_of_bins - max_index) % d_number_of_bins;
+        }
+
+        bool phy_decoder_impl::demodulate(const gr_complex *samples, const bool is_first) {
+            float samples_ifreq[d_samples_per_symbol];
+
+            samples_to_file("/tmp/data", &samples[0], d_samples_per_symbol, sizeof(gr_complex));
+
+            // The instantaneous frequency serves both the bin search and the timing tracker
+            received_frequency(samples, samples_ifreq, d_samples_per_symbol);
+
+            uint32_t bin_idx = max_frequency_gradient_idx(samples_ifreq);
+            //uint32_t bin_idx = get_shift_fft(samples);
+
+            // How well the symbol matches the chirp of the bin it was demodulated to
+            d_ctx->symbol_quality = cross_correlate_ifreq_centered(samples_ifreq,
+                &d_upchirp_ifreq_v_centered[((bin_idx+1) % d_number_of_bins) * d_decim_factor + d_samples_per_symbol],
+                d_upchirp_ifreq_energy, d_samples_per_symbol);
+            if(d_enable_fine_sync)
+                track_timing(samples_ifreq, bin_idx, std::max(d_decim_factor / 4u, 2u));
+
+            GRLORA_LOG(DEMOD, TRACE, "bin {}", bin_idx);
+            d_ctx->words.push_back(bin_idx);
+
+            // Look for 4+cr symbols and stop
+
+            if (d_ctx->words.size() == (4u + (is_first ? 4u : d_ctx->phdr.cr))) {
+                if (!is_first && d_ctx->infer_reduced_rate) {
+                    d_ctx->reduced_rate       = looks_reduced_rate();
+                    d_ctx->infer_reduced_rate = false;
+                    GRLORA_LOG(DECODE, DEBUG, "Reduced rate: {}", (uint32_t)d_ctx->reduced_rate);
+                }
+
+                const bool reduced_rate = is_first || d_ctx->reduced_rate;
+                for (uint32_t& word : d_ctx->words) {
+                    // Header has additional redundancy
+                    if (reduced_rate)
+                        word = std::lround(word / 4.0f) % d_number_of_bins_hdr;
+
+                    // Decode (actually gray encode) the bin to get the symbol value
+                    word ^= word >> 1u;
+                }
+
+                // Deinterleave
+                deinterleave(reduced_rate ? d_sf - 2u : d_sf);
+
+                return true; // Signal that a block is ready for decoding
+            }
+
+            return false; // We need more words in order to decode a block
+        }
+
+        /**
+         *  One symbol may be off, to survive a demodulation error. Random bins fall on a multiple of 4 a quarter
+         *  of the time, so a block without the optimization still passes once in 60 at CR 4/5, and once in 2600
+         *  at 4/8.
+         */
+        bool phy_decoder_impl::looks_reduced_rate(void) const {
+            uint32_t aligned = 0u;
+
+            for (const uint32_t bin : d_ctx->words)
+                aligned += (bin % 4u) == 0u;
+
+            return aligned + 1u >= d_ctx->words.size();
+        }
+
+        int32_t phy_decoder_impl::payload_symbols(void) const {
+            const uint8_t redundancy = (d_ctx->reduced_rate ? 2 : 0);
+            const int symbols_per_block = d_ctx->phdr.cr + 4u;
+            const float bits_needed     = float(d_ctx->payload_length) * 8.0f;
+            const float symbols_needed  = bits_needed * (symbols_per_block / 4.0f) / float(d_sf - redundancy);
+            const int blocks_needed     = (int)std::ceil(symbols_needed / symbols_per_block);
+
+            return blocks_needed * symbols_per_block;
+        }
+
+        /**
+         *  Correct the interleaving by extracting each column of bits after rotating to the left.
+         *  <br/>(The words were interleaved diagonally, by rotating we make them straight into columns.)
+         */
+        void phy_decoder_impl::deinterleave(const uint32_t ppm) {
+            const uint32_t bits_per_word = d_ctx->words.size();
+            const uint32_t offset_start  = ppm - 1u;
+
+            std::vector<uint8_t> words_deinterleaved(ppm, 0u);
+
+            if (bits_per_word > 8u) {
+                // Not sure if this can ever occur. It would imply coding rate high than 4/8 e.g. 4/9.
+                std::cerr << "[LoRa Decoder] WARNING : Deinterleaver: More than 8 bits per word. uint8_t will not be sufficient!\nBytes need to be stored in intermediate array and then packed into words_deinterleaved!" << std::endl;
+                exit(1);
+            }
+
+            for (uint32_t i = 0u; i < bits_per_word; i++) {
+                const uint32_t word = gr::lora::rotl(d_ctx->words[i], i, ppm);
+
+                for (uint32_t j = (1u << offset_start), x = offset_start; j; j >>= 1u, x--) {
+                    words_deinterleaved[x] |= !!(word & j) << i;
+                }
+            }
+
+            GRLORA_LOG(DECODE, TRACE, "D: {}", logging::bin(&words_deinterleaved[0], words_deinterleaved.size()));
+
+            // Add to demodulated data
+            d_ctx->demodulated.insert(d_ctx->demodulated.end(), words_deinterleaved.begin(), words_deinterleaved.end());
+
+            // Cleanup
+            d_ctx->words.clear();
+        }
+
+        void phy_decoder_impl::decode(const bool is_header) {
+            static const uint8_t shuffle_pattern[] = {5, 0, 1, 2, 4, 3, 6, 7};
+
+            deshuffle(shuffle_pattern, is_header);
+
+            // The MAC CRC after the payload is sent as is
+            const bool has_crc = !is_header && !d_ctx->implicit && d_ctx->phdr.has_mac_crc;
+            const uint32_t whitened = has_crc ? 2u * d_ctx->phdr.length : d_ctx->words_deshuffled.size();
+
+            dewhiten(is_header ? gr::lora::prng_header :
+                (d_ctx->phdr.cr <=2) ? gr::lora::prng_payload_cr56 : gr::lora::prng_payload_cr78, whitened);
+
+            hamming_decode(is_header);
+        }
+
+        crc_status phy_decoder_impl::check_crc(void) {
+            if (d_ctx->implicit || !d_ctx->phdr.has_mac_crc)
+                return crc_status::NONE;
+
+            if (d_ctx->decoded.size() < d_ctx->phdr.length + MAC_CRC_SIZE)
+                return crc_status::INVALID;
+
+            // Sent little-endian
+            d_ctx->mac_crc = d_ctx->decoded[d_ctx->phdr.length] | ((uint16_t)d_ctx->decoded[d_ctx->phdr.length + 1u] << 8u);
+
+            return d_ctx->mac_crc == payload_crc(&d_ctx->decoded[0], d_ctx->phdr.length) ? crc_status::VALID : crc_status::INVALID;
+        }
+
+        /**
+         *  Store the `rx_time` of the radio at input sample `sample`, the reference of `arrival_ns`.
+         */
+        void phy_decoder_impl::set_time_reference(const uint64_t sample, const uint64_t ns) {
+            d_time_ref_sample = sample;
+            d_time_ref_ns     = ns;
+        }
+
+        uint64_t phy_decoder_impl::arrival_ns(const uint64_t sample) const {
+            if (!d_time_ref_ns)
+                return 0u;
+
+            const double offset = ((double)sample - (double)d_time_ref_sample) / d_samples_per_second;
+            return (uint64_t)((int64_t)d_time_ref_ns + (int64_t)(offset * 1e9));
+        }
+
+        /**
+         *  Fill a pooled frame in place. The frame returns to `d_frame_pool` once every holder has
+         *  released it.
+         */
+        frame_sptr phy_decoder_impl::build_frame(void) {
+            frame_sptr f = d_frame_pool->acquire();
+            loratap_header_t* loratap_header = f->loratap_header();
+
+            // NaN without a noise reference, and infinite over the exact zeros of a synthetic input. LoRaTap
+            // gets whole dB within the range of its field, 0 if unknown.
+            const float snr_db = 10.0f * log10(d_ctx->snr);
+
+            memset(loratap_header, 0, sizeof(loratap_header_t));
+            loratap_header->rssi.snr  = std::isnan(snr_db) ? 0u : (uint8_t)(std::min(std::max(snr_db, 0.0f), 255.0f) + 0.5f);
+            loratap_header->sync_word = d_ctx->sync_word;
+            loratap_header->channel.sf = d_sf;
+
+            memcpy(f->phy_header(), &d_ctx->phdr, sizeof(loraphy_header_t));
+            f->set_payload_length(std::min(d_ctx->payload_length, (uint32_t)d_ctx->decoded.size()));
+            memcpy(f->payload(), &d_ctx->decoded[0], f->payload_length());
+
+            f->channel().snr = snr_db;
+            f->channel().cfo = d_ctx->cfo_estimation;
+            f->channel().inverted_iq = d_ctx->inverted;
+            f->set_crc(d_ctx->crc);
+
+            d_ctx->timing.publish_sample = d_ctx->position;
+            d_ctx->timing.publish_ns     = wall_time_ns();
+            f->timing()             = d_ctx->timing;
+            record_latency(latency_stage::PUBLISH, (int64_t)(d_ctx->timing.publish_ns - latency_origin_ns(d_ctx->timing)));
+
+            return f;
+        }
+
+        void phy_decoder_impl::deshuffle(const uint8_t *shuffle_pattern, const bool is_header) {
+            const uint32_t to_decode = is_header ? 5u : d_ctx->demodulated.size();
+            const uint32_t len       = sizeof(shuffle_pattern) / sizeof(uint8_t);
+            uint8_t result;
+
+            for (uint32_t i = 0u; i < to_decode; i++) {
+                result = 0u;
+
+                for (uint32_t j = 0u; j < len; j++) {
+                    result |= !!(d_ctx->demodulated[i] & (1u << shuffle_pattern[j])) << j;
+                }
+
+                d_ctx->words_deshuffled.push_back(result);
+            }
+
+            GRLORA_LOG(DECODE, TRACE, "S: {}", logging::bin(&d_ctx->words_deshuffled[0], d_ctx->words_deshuffled.size()));
+
+            // We're done with these words
+            if (is_header){
+                d_ctx->demodulated.erase(d_ctx->demodulated.begin(), d_ctx->demodulated.begin() + 5u);
+                d_ctx->words_deshuffled.push_back(0);
+            } else {
+                d_ctx->demodulated.clear();
+            }
+        }
+
+        void phy_decoder_impl::dewhiten(const uint8_t *prng, const uint32_t whitened) {
+            const uint32_t len = d_ctx->words_deshuffled.size();
+
+            for (uint32_t i = 0u; i < len; i++) {
+                uint8_t xor_b = i < whitened ? d_ctx->words_deshuffled[i] ^ prng[i] : d_ctx->words_deshuffled[i];
+                d_ctx->words_dewhitened.push_back(xor_b);
+            }
+
+            GRLORA_LOG(DECODE, TRACE, "W: {}", logging::bin(&d_ctx->words_dewhitened[0], d_ctx->words_dewhitened.size()));
+
+            d_ctx->words_deshuffled.clear();
+        }
+
+        void phy_decoder_impl::hamming_decode(bool is_header) {
+            switch(d_ctx->phdr.cr) {
+                case 4: case 3: { // Hamming(8,4) or Hamming(7,4)
+                    //hamming_decode_soft(is_header);
+                    uint32_t n = ceil(d_ctx->words_dewhitened.size() * 4.0f / (4.0f + d_ctx->phdr.cr));
+
+                    d_ctx->decoded.resize(n);    // Capacity is reserved up front, so this does not allocate
+                    fec_decode(d_h48_fec, n, &d_ctx->words_dewhitened[0], &d_ctx->decoded[0]);
+                    if(!is_header)
+                        swap_nibbles(&d_ctx->decoded[0], n);
+                    break;
+                }
+                case 2: case 1: { // Hamming(6,4) or Hamming(5,4)
+                    // TODO: Report parity error to the user
+                    extract_data_only(is_header);
+                    break;
+                }
+            }
+
+            d_ctx->words_dewhitened.clear();
+        }
+
+        /**
+         * Deprecated
+         */
+        void phy_decoder_impl::hamming_decode_soft(bool is_header) {
+            uint32_t len = d_ctx->words_dewhitened.size();
+            for (uint32_t i = 0u; i < len; i += 2u) {
+                const uint8_t d2 = (i + 1u < len) ? hamming_decode_soft_byte(d_ctx->words_dewhitened[i + 1u]) : 0u;
+                const uint8_t d1 = hamming_decode_soft_byte(d_ctx->words_dewhitened[i]);
+
+                if(is_header)
+                    d_ctx->decoded.push_back((d1 << 4u) | d2);
+                else
+                    d_ctx->decoded.push_back((d2 << 4u) | d1);
+            }
+        }
+
+        void phy_decoder_impl::extract_data_only(bool is_header) {
+            static const uint8_t data_indices[4] = {1, 2, 3, 5};
+            uint32_t len = d_ctx->words_dewhitened.size();
+
+            for (uint32_t i = 0u; i < len; i += 2u) {
+                const uint8_t d2 = (i + 1u < len) ? select_bits(d_ctx->words_dewhitened[i + 1u], data_indices, 4u) & 0xFF : 0u;
+                const uint8_t d1 = (select_bits(d_ctx->words_dewhitened[i], data_indices, 4u) & 0xFF);
+
+                if(is_header)
+                    d_ctx->decoded.push_back((d1 << 4u) | d2);
+                else
+                    d_ctx->decoded.push_back((d2 << 4u) | d1);
+            }
+        }
+
+        /**
+         *  Old method to determine CFO. Currently unused.
+         */
+        void phy_decoder_impl::determine_cfo(const gr_complex *samples) {
+            float iphase[d_samples_per_symbol];
+            const float div = (float) d_samples_per_second / (2.0f * M_PI);
+
+            // Determine instant phase
+            instantaneous_phase(samples, iphase, d_samples_per_symbol);
+
+            float sum = 0.0f;
+
+            for (uint32_t i = 1u; i < d_samples_per_symbol; i++) {
+                sum += (float)((iphase[i] - iphase[i - 1u]) * div);
+            }
+
+            d_ctx->cfo_estimation = sum / (float)(d_samples_per_symbol - 1u);
+        }
+
+        /**
+         * New method to determine CFO.
+         */
+        float phy_decoder_impl::experimental_determine_cfo(const gr_complex *samples, uint32_t window) {
+            gr_complex mult[window];
+            float mult_ifreq[window];
+
+            volk_32fc_x2_multiply_32fc(mult, samples, &d_downchirp[0], window);
+            instantaneous_frequency(mult, mult_ifreq, window);
+
+            return mult_ifreq[256] / (2.0 * M_PI) * d_samples_per_second;
+        }
+
+        std::vector<frame_sptr> phy_decoder_impl::process(const gr_complex* samples, size_t length) {
+            std::vector<frame_sptr> frames;
+            size_t offset = 0u;
+
+            // Finish the kept samples with just enough of the new block, then decode straight from the caller's buffer
+            if (!d_carry.empty()) {
+                const size_t carried = d_carry.size();
+                d_carry.insert(d_carry.end(), samples, samples + std::min(length, (size_t)lookahead()));
+
+                // Every context needs to get past the kept samples before the caller's buffer takes over
+                const size_t consumed = run(&d_carry[0], d_carry.size(), d_position + carried, frames);
+                if (consumed < carried) {
+                    // Only possible when the whole block fit in the carry
+                    d_carry.erase(d_carry.begin(), d_carry.begin() + consumed);
+                    return frames;
+                }
+
+                offset = consumed - carried;
+                d_carry.clear();
+            }
+
+            offset += consume(samples + offset, length - offset, frames);
+            if (offset < length)
+                d_carry.assign(samples + offset, samples + length);
+
+            return frames;
+        }
+
+        size_t phy_decoder_impl::consume(const gr_complex* samples, size_t length, std::vector<frame_sptr>& frames) {
+            return run(samples, length, UINT64_MAX, frames);
+        }
+
+        std::vector<frame_sptr> phy_decoder_impl::flush(void) {
+            std::vector<frame_sptr> frames;
+            const size_t kept = d_carry.size();
+
+            // Steps may look up to two symbols past the last kept sample, into the padding
+            d_carry.resize(kept + lookahead(), gr_complex(0.0f, 0.0f));
+            run(&d_carry[0], d_carry.size(), d_position + kept, frames);
+
+            d_carry.clear();
+            return frames;
+        }
+
+        /**
+         *  The detector and the packet contexts read the same input at their own positions. Only the samples
+         *  before the lagging one can be released, so it is always the one to step.
+         */
+        size_t phy_decoder_impl::run(const gr_complex* samples, size_t length, uint64_t limit, std::vector<frame_sptr>& frames) {
+            const uint64_t start = d_position;
+            packet_context_t* ctx = &lagging();
+
+            // A context consumes nothing at most twice in a row (DETECT -> SYNC -> FIND_SFD)
+            while (ctx->position < limit && ctx->position - start + lookahead() <= length) {
+                // With shared detection, DETECT waits where the detector stopped, for the next block
+                if (d_shared_detection && ctx->state == gr::lora::DecoderState::DETECT && ctx->position >= d_shared_frontier)
+                    break;
+
+                step(*ctx, samples + (ctx->position - start), frames);
+                ctx = &lagging();
+            }
+
+            d_position = ctx->position;
+            return d_position - start;
+        }
+
+        packet_context_t& phy_decoder_impl::lagging(void) {
+            packet_context_t* lagging = &d_acquisition;
+
+            for (packet_context_t& ctx : d_packets) {
+                if (ctx.state != gr::lora::DecoderState::DETECT && ctx.position < lagging->position)
+                    lagging = &ctx;
+            }
+
+            return *lagging;
+        }
+
+        bool phy_decoder_impl::demodulating(void) const {
+            for (const packet_context_t& ctx : d_packets) {
+                if (ctx.state != gr::lora::DecoderState::DETECT)
+                    return true;
+            }
+
+            return false;
+        }
+
+        void phy_decoder_impl::reset(void) {
+            d_position = 0u;
+            d_carry.clear();
+            d_pwr_queue.clear();
+            d_noise_power     = -1.0f;
+            d_shared_hits.clear();
+            d_shared_frontier = 0u;
+            d_time_ref_ns     = 0u;     // Positions restart at zero
+
+            d_ctx = &d_acquisition;
+            drop_frame();
+            d_acquisition.position = 0u;
+            for (packet_context_t& ctx : d_packets) {
+                d_ctx = &ctx;
+                drop_frame();
+            }
+            d_ctx = &d_acquisition;
+            d_frame_end = 0u;
+
+            d_counters_origin = 0u;
+        }
+
+        void phy_decoder_impl::start_packet(const uint64_t position) {
+            for (packet_context_t& ctx : d_packets) {
+                if (ctx.state != gr::lora::DecoderState::DETECT)
+                    continue;
+
+                // Every frame starts from the configuration, unless its header and first payload block tell
+                const bool autodetect = d_autodetect.load(std::memory_order_relaxed);
+                ctx.state              = gr::lora::DecoderState::DECODE_HEADER;
+                ctx.position           = position;
+                ctx.implicit           = d_config_implicit && !autodetect;
+                ctx.reduced_rate       = d_config_reduced_rate && !autodetect;
+                ctx.infer_header       = autodetect;
+                ctx.infer_reduced_rate = autodetect;
+                ctx.phdr               = d_config_phdr;
+                ctx.crc                = crc_status::NONE;
+                ctx.weak_symbols       = 0u;
+                ctx.weak_start         = 0u;
+
+                // Channel estimates of the preamble
+                ctx.sync_word          = d_acquisition.sync_word;
+                ctx.inverted           = d_acquisition.inverted;
+                ctx.energy_threshold   = d_acquisition.energy_threshold;
+                ctx.snr                = d_acquisition.snr;
+                ctx.cfo_estimation     = d_acquisition.cfo_estimation;
+                ctx.timing             = d_acquisition.timing;
+                return;
+            }
+
+            GRLORA_LOG(SYNC, DEBUG, "No free packet context");
+            increment(d_context_aborts);
+        }
+
+        uint32_t phy_decoder_impl::step(packet_context_t& ctx, const gr_complex *input, std::vector<frame_sptr>& frames) {
+            const uint64_t start     = ticks();
+            const DecoderState state = ctx.state;
+            uint32_t consumed        = 0u;
+
+            if (d_reset_counters.exchange(false, std::memory_order_relaxed)) {
+                clear_counters();
+                d_counters_origin = d_acquisition.position;
+            }
+
+            d_ctx = &ctx;
+
+            d_ctx->fine_sync = 0; // Always reset fine sync
+
+            switch (d_ctx->state) {
+                case gr::lora::DecoderState::DETECT: {
+                    float correlation = 0.0f;
+
+                    if (d_shared_detection) {
+                        // Preambles passed while demodulating are stale
+                        while (!d_shared_hits.empty() && d_shared_hits.front().position < d_ctx->position)
+                            d_shared_hits.pop_front();
+
+                        if (d_shared_hits.empty() || d_shared_hits.front().position != d_ctx->position) {
+                            // Up to the next preamble, without going past what the detector has covered. `run` does
+                            // not step DETECT at the frontier, so this always moves on.
+                            const uint64_t next = d_shared_hits.empty() ? d_shared_frontier
+                                                                        : std::min(d_shared_hits.front().position, d_shared_frontier);
+                            consumed = next > d_ctx->position ? (uint32_t)std::min<uint64_t>(next - d_ctx->position, d_samples_per_symbol)
+                                                              : 0u;
+                            break;
+                        }
+
+                        // The SNR compares the preamble with the noise power the detector saw a few symbols before it
+                        const preamble_hit_t& hit = d_shared_hits.front();
+                        if (!demodulating() && hit.position >= d_frame_end + (DETECTOR_NOISE_WINDOWS - 1u) * d_samples_per_symbol)
+                            d_noise_power = hit.noise_power;
+                        d_shared_hits.pop_front();
+                    } else if (demodulating()) {
+                        // The input is another frame, not noise: only this symbol is kept, as the preamble power
+                        d_pwr_queue.clear();
+                    }
+
+                    correlation = detect_preamble_autocorr(input, d_samples_per_symbol);
+
+                    // The oldest power of the queue is the noise reference, once it is past the last frame
+                    if (!d_shared_detection && !demodulating() && d_pwr_queue.size() >= 2 &&
+                        d_ctx->position >= d_frame_end + (d_pwr_queue.size() - 1u) * d_samples_per_symbol)
+                        d_noise_power = d_pwr_queue[0];
+
+                    if (correlation >= 0.90f) {
+                        determine_snr();
+                        GRLORA_LOG(SYNC, DEBUG, "Ca: {}", correlation);
+                        d_corr_fails = 0u;
+                        d_ctx->state = gr::lora::DecoderState::SYNC;
+                        increment(d_detections);
+
+                        d_ctx->timing               = frame_timing_t();
+                        d_ctx->timing.detect_sample = d_ctx->position;
+                        d_ctx->timing.detect_ns     = wall_time_ns();
+                        d_ctx->timing.arrival_ns    = arrival_ns(d_ctx->position + lookahead());
+                        break;
+                    }
+
+                    consumed = d_shared_detection ? 0u : d_samples_per_symbol;
+
+                    break;
+                }
+
+                case gr::lora::DecoderState::SYNC: {
+                    int i = 0;
+                    detect_upchirp(input, d_samples_per_symbol, &i);
+
+                    //float cfo = experimental_determine_cfo(&input[i], d_samples_per_symbol);
+
+                    samples_to_file("/tmp/detect",  &input[i], d_samples_per_symbol, sizeof(gr_complex));
+
+                    d_ctx->timing.sync_sample = d_ctx->position + i;
+                    d_ctx->cfo_estimation = 0.0f;
+                    if (d_estimate_cfo)
+                        determine_cfo(&input[i]);
+
+                    consumed = i;
+                    d_sync_bins[0] = d_sync_bins[1] = 0u;
+                    d_ctx->state = gr::lora::DecoderState::FIND_SFD;
+                    increment(d_sfd_searches);
+                    break;
+                }
+
+                case gr::lora::DecoderState::FIND_SFD: {
+                    float samples_ifreq[d_samples_per_symbol];
+                    received_frequency(input, samples_ifreq, d_samples_per_symbol);
+                    const float c = detect_downchirp(samples_ifreq, d_samples_per_symbol);
+
+                    GRLORA_LOG(SYNC, TRACE, "Cd: {}", c);
+
+                    if (c > 0.96f) {
+                        GRLORA_LOG(SYNC, DEBUG, "SYNC: {}", c);
+                        // Debug stuff
+                        samples_to_file("/tmp/sync", input, d_samples_per_symbol, sizeof(gr_complex));
+
+                        // The two symbols before the SFD carry the sync word
+                        d_ctx->sync_word = sync_word_from_bins();
+                        if (sync_word_accepted(d_ctx->sync_word)) {
+                            d_ctx->state = gr::lora::DecoderState::PAUSE;
+
+                            d_ctx->timing.sfd_sample = d_ctx->position;
+                            d_ctx->timing.sfd_ns     = wall_time_ns();
+                            record_latency(latency_stage::SFD, (int64_t)(d_ctx->timing.sfd_ns - latency_origin_ns(d_ctx->timing)));
+                        } else {
+                            GRLORA_LOG(SYNC, DEBUG, "Sync word {} not accepted", (uint32_t)d_ctx->sync_word);
+                            d_ctx->state = gr::lora::DecoderState::DETECT;
+                            increment(d_sync_word_aborts);
+                        }
+                    } else {
+                        d_sync_bins[0] = d_sync_bins[1];
+                        d_sync_bins[1] = max_frequency_gradient_idx(samples_ifreq);
+
+                        if(c < -0.97f) {
+                            // TODO: Check d_upchirp_ifreq_v: bin -1 gives different result compared to bin d_number_of_bins-1, which shouldn't be the case.
+                            fine_sync(input, -1, d_decim_factor * 4);
+                        } else {
+                            d_corr_fails++;
+                        }
+
+                        if (d_corr_fails > 4u) {
+                            d_ctx->state = gr::lora::DecoderState::DETECT;
+                            increment(d_sync_aborts);
+                            GRLORA_LOG(SYNC, DEBUG, "Lost sync");
+                        }
+                    }
+
+                    consumed = (int32_t)d_samples_per_symbol+d_ctx->fine_sync;
+                    break;
+                }
+
+                case gr::lora::DecoderState::PAUSE: {
+                    // The frame goes on in a packet context, while this one looks for the next preamble
+                    consumed = d_samples_per_symbol + d_delay_after_sync;
+                    start_packet(d_ctx->position + consumed);
+
+                    d_ctx->state = gr::lora::DecoderState::DETECT;
+                    break;
+                }
+
+                case gr::lora::DecoderState::DECODE_HEADER: {
+                    if (demodulate(input, true)) {
+                        if (!d_ctx->implicit) {
+                            // Kept in case the block turns out to be payload
+                            if (d_ctx->infer_header)
+                                d_ctx->header_block.assign(d_ctx->demodulated.begin(), d_ctx->demodulated.end());
+
+                            decode(true);
+                            GRLORA_LOG(FRAME, DEBUG, "Header:{}", logging::hex(&d_ctx->decoded[0], d_ctx->decoded.size()));
+
+                            // Most false detections end here, instead of demodulating up to 255 bytes of noise
+                            if (!d_ctx->infer_header && !header_checksum(&d_ctx->decoded[0])) {
+                                GRLORA_LOG(DECODE, DEBUG, "Header checksum mismatch");
+                                increment(d_header_aborts);
+                                drop_frame();
+                                consumed = (int32_t)d_samples_per_symbol+d_ctx->fine_sync;
+                                break;
+                            }
+
+                            if (d_ctx->infer_header && !header_plausible(&d_ctx->decoded[0])) {
+                                GRLORA_LOG(DECODE, DEBUG, "Header checksum mismatch, decoding without header");
+                                increment(d_inferred_implicit);
+
+                                d_ctx->implicit = true;
+                                d_ctx->demodulated.swap(d_ctx->header_block);
+                                d_ctx->decoded.clear();
+                            }
+                        }
+
+                        if (d_ctx->implicit) {
+                            d_ctx->payload_symbols = 1;
+                        } else {
+                            memcpy(&d_ctx->phdr, &d_ctx->decoded[0], sizeof(loraphy_header_t));
+                            if (d_ctx->phdr.cr > 4)
+                                d_ctx->phdr.cr = 4;
+                            d_ctx->decoded.clear();
+
+                            d_ctx->payload_length = d_ctx->phdr.length + MAC_CRC_SIZE * d_ctx->phdr.has_mac_crc;
+                            //d_phy_crc = SM(decoded[1], 4, 0xf0) | MS(decoded[2], 0xf0, 4);
+
+                            // Calculate number of payload symbols needed
+                            d_ctx->payload_symbols = payload_symbols();
+
+                            GRLORA_LOG(DECODE, DEBUG, "LEN: {} ({} symbols)", d_ctx->payload_length, d_ctx->payload_symbols);
+                            increment(d_headers);
+                        }
+                        d_ctx->weak_symbols = 0u;
+                        d_ctx->state = gr::lora::DecoderState::DECODE_PAYLOAD;
+                    }
+
+                    consumed = (int32_t)d_samples_per_symbol+d_ctx->fine_sync;
+                    break;
+                }
+
+                case gr::lora::DecoderState::DECODE_PAYLOAD: {
+                    if (d_ctx->implicit && determine_energy(input) < d_ctx->energy_threshold) {
+                        d_ctx->payload_symbols = 0;
+                        //d_ctx->demodulated.erase(d_ctx->demodulated.begin(), d_ctx->demodulated.begin() + 7u); // Test for SF 8 with header
+                    } else {
+                        const bool   reduced_rate = d_ctx->reduced_rate;
+                        const size_t demodulated  = d_ctx->demodulated.size();
+
+                        if (demodulate(input, false) && !d_ctx->implicit) {
+                            // The first block may have switched to the low data rate optimization
+                            if (d_ctx->reduced_rate != reduced_rate)
+                                d_ctx->payload_symbols = payload_symbols();
+                            d_ctx->payload_symbols -= (4u + d_ctx->phdr.cr);
+                        }
+
+                        // A frame that ended early or was run over by another one will not decode anymore.
+                        // Frames configured without header end on their energy alone, as above.
+                        if ((!d_ctx->implicit || d_ctx->infer_header) &&
+                            (d_ctx->symbol_quality < DECODER_MIN_SYMBOL_QUALITY || determine_energy(input) < d_ctx->energy_threshold)) {
+                            if (d_ctx->weak_symbols++ == 0u)
+                                d_ctx->weak_start = demodulated;
+
+                            if (d_ctx->weak_symbols >= DECODER_MAX_WEAK_SYMBOLS) {
+                                if (d_ctx->implicit) {
+                                    // Without header, this is how the frame ends; blocks holding weak symbols are not part of it
+                                    d_ctx->demodulated.resize(d_ctx->weak_start);
+                                    d_ctx->payload_symbols = 0;
+                                } else if (d_ctx->demodulated.size() >= 2u * d_ctx->payload_length) {
+                                    // Every payload codeword is in: `d_ctx->payload_symbols` overestimates frames that fill the header block
+                                    d_ctx->payload_symbols = 0;
+                                } else {
+                                    GRLORA_LOG(DECODE, DEBUG, "Payload lost, {} symbols left", d_ctx->payload_symbols);
+                                    increment(d_payload_aborts);
+                                    drop_frame();
+                                    consumed = (int32_t)d_samples_per_symbol+d_ctx->fine_sync;
+                                    break;
+                                }
+                            }
+                        } else {
+                            d_ctx->weak_symbols = 0u;
+                        }
+
+                        if (d_ctx->implicit && d_ctx->demodulated.size() >= 2u * LORA_FRAME_MAX_PAYLOAD)
+                            d_ctx->payload_symbols = 0;
+                    }
+
+                    if (d_ctx->payload_symbols <= 0) {
+                        if (d_ctx->implicit)
+                            d_ctx->payload_length = (int32_t)(d_ctx->demodulated.size() / 2);
+
+                        decode(false);
+                        GRLORA_LOG(FRAME, INFO, "{}", logging::hex(&d_ctx->decoded[0], d_ctx->payload_length));
+
+                        d_ctx->crc = check_crc();
+                        if (d_ctx->crc == crc_status::INVALID) {
+                            GRLORA_LOG(DECODE, DEBUG, "CRC mismatch: {}", d_ctx->mac_crc);
+                            increment(d_crc_errors);
+                        }
+
+                        if (d_ctx->crc != crc_status::INVALID || !d_drop_invalid.load(std::memory_order_relaxed))
+                            frames.push_back(build_frame());
+
+                        increment(d_payloads);
+                        drop_frame();
+                    }
+
+                    consumed = (int32_t)d_samples_per_symbol+d_ctx->fine_sync;
+
+                    break;
+                }
+
+                case gr::lora::DecoderState::STOP: {
+                    consumed = d_samples_per_symbol;
+                    break;
+                }
+
+                default: {
+                    std::cerr << "[LoRa Decoder] WARNING : No state! Shouldn't happen\n";
+                    break;
+                }
+            }
+
+            d_ctx->position += consumed;
+            d_samples_consumed.store(d_acquisition.position - d_counters_origin, std::memory_order_relaxed);
+
+            count_state(state, ticks() - start);
+            return consumed;
+        }
+
+        void phy_decoder_impl::drop_frame(void) {
+            // The power queue of `DecoderState::DETECT` starts over after each frame
+            if (d_ctx != &d_acquisition) {
+                d_frame_end = std::max(d_frame_end, d_ctx->position + d_samples_per_symbol);
+                d_pwr_queue.clear();
+            }
+
+            d_ctx->state = gr::lora::DecoderState::DETECT;
+            d_ctx->decoded.clear();
+            d_ctx->words.clear();
+            d_ctx->words_dewhitened.clear();
+            d_ctx->words_deshuffled.clear();
+            d_ctx->demodulated.clear();
+        }
+
+        uint64_t phy_decoder_impl::ticks(void) {
+            #if defined(__x86_64__) || defined(__i386__)
+                return __rdtsc();
+            #else
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            #endif
+        }
+
+        void phy_decoder_impl::count_state(const DecoderState state, const uint64_t elapsed) {
+            state_counters_t& c = d_state_counters[(size_t)state];
+            const uint32_t bin  = 63u - __builtin_clzll(elapsed | 1u);
+
+            add(c.ticks, elapsed);
+            increment(c.visits);
+            increment(c.histogram[bin]);
+        }
+
+        void phy_decoder_impl::clear_counters(void) {
+            for (state_counters_t& c : d_state_counters) {
+                c.ticks.store(0u, std::memory_order_relaxed);
+                c.visits.store(0u, std::memory_order_relaxed);
+                for (std::atomic<uint64_t>& h : c.histogram)
+                    h.store(0u, std::memory_order_relaxed);
+            }
+
+            d_samples_consumed.store(0u, std::memory_order_relaxed);
+            d_detections.store(0u, std::memory_order_relaxed);
+            d_sfd_searches.store(0u, std::memory_order_relaxed);
+            d_sync_aborts.store(0u, std::memory_order_relaxed);
+            d_headers.store(0u, std::memory_order_relaxed);
+            d_sync_word_aborts.store(0u, std::memory_order_relaxed);
+            d_header_aborts.store(0u, std::memory_order_relaxed);
+            d_inferred_implicit.store(0u, std::memory_order_relaxed);
+            d_payloads.store(0u, std::memory_order_relaxed);
+            d_crc_errors.store(0u, std::memory_order_relaxed);
+            d_payload_aborts.store(0u, std::memory_order_relaxed);
+            d_context_aborts.store(0u, std::memory_order_relaxed);
+        }
+
+        uint64_t phy_decoder_impl::num_symbols(void) {
+            return d_samples_consumed.load(std::memory_order_relaxed) / d_samples_per_symbol;
+        }
+
+        uint64_t phy_decoder_impl::num_detections(void) {
+            return d_detections.load(std::memory_order_relaxed);
+        }
+
+        uint64_t phy_decoder_impl::num_sfd_searches(void) {
+            return d_sfd_searches.load(std::memory_order_relaxed);
+        }
+
+        uint64_t phy_decoder_impl::num_sync_aborts(void) {
+            return d_sync_aborts.load(std::memory_order_relaxed);
+        }
+
+        uint64_t phy_decoder_impl::num_headers(void) {
+            return d_headers.load(std::memory_order_relaxed);
+        }
+
+        uint64_t phy_decoder_impl::num_sync_word_aborts(void) {
+            return d_sync_word_aborts.load(std::memory_order_relaxed);
+        }
+
+        uint64_t phy_decoder_impl::num_header_aborts(void) {
+            return d_header_aborts.load(std::memory_order_relaxed);
+        }
+
+        uint64_t phy_decoder_impl::num_inferred_implicit(void) {
+            return d_inferred_implicit.load(std::memory_order_relaxed);
+        }
+
+        uint64_t phy_decoder_impl::num_payloads(void) {
+            return d_payloads.load(std::memory_order_relaxed);
+        }
+
+        uint64_t phy_decoder_impl::num_payload_aborts(void) {
+            return d_payload_aborts.load(std::memory_order_relaxed);
+        }
+
+        uint64_t phy_decoder_impl::num_context_aborts(void) {
+            return d_context_aborts.load(std::memory_order_relaxed);
+        }
+
+        uint64_t phy_decoder_impl::num_crc_errors(void) {
+            return d_crc_errors.load(std::memory_order_relaxed);
+        }
+
+        std::map<std::string, uint64_t> phy_decoder_impl::state_ticks(void) {
+            std::map<std::string, uint64_t> result;
+
+            for (size_t i = 0u; i < (size_t)DecoderState::NUM_STATES; i++)
+                result[state_to_string((DecoderState)i)] = d_state_counters[i].ticks.load(std::memory_order_relaxed);
+
+            return result;
+        }
+
+        std::map<std::string, uint64_t> phy_decoder_impl::state_visits(void) {
+            std::map<std::string, uint64_t> result;
+
+            for (size_t i = 0u; i < (size_t)DecoderState::NUM_STATES; i++)
+                result[state_to_string((DecoderState)i)] = d_state_counters[i].visits.load(std::memory_order_relaxed);
+
+            return result;
+        }
+
+        std::vector<uint64_t> phy_decoder_impl::state_histogram(const std::string& state) {
+            for (size_t i = 0u; i < (size_t)DecoderState::NUM_STATES; i++) {
+                if (state != state_to_string((DecoderState)i))
+                    continue;
+
+                std::vector<uint64_t> result(DECODER_HISTOGRAM_BINS);
+                for (uint32_t b = 0u; b < DECODER_HISTOGRAM_BINS; b++)
+                    result[b] = d_state_counters[i].histogram[b].load(std::memory_order_relaxed);
+
+                return result;
+            }
+
+            std::cerr << "[LoRa Decoder] WARNING : Unknown state " << state << " for histogram." << std::endl;
+            return std::vector<uint64_t>();
+        }
+
+        void phy_decoder_impl::reset_counters(void) {
+            d_reset_counters = true;
+        }
+
+        std::vector<float> phy_decoder_impl::state_load(void) {
+            std::vector<float> result((size_t)DecoderState::NUM_STATES);
+            uint64_t total = 0u;
+
+            for (size_t i = 0u; i < result.size(); i++) {
+                result[i] = d_state_counters[i].ticks.load(std::memory_order_relaxed);
+                total    += result[i];
+            }
+
+            for (float& r : result)
+                r = total ? r / total : 0.0f;
+
+            return result;
+        }
+    } /* namespace lora */
+} /* namespace gr */
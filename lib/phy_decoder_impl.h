@@ -0,0 +1,712 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017 Pieter Robyns, William Thenaers.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LORA_PHY_DECODER_IMPL_H
+#define INCLUDED_LORA_PHY_DECODER_IMPL_H
+
+#include <liquid/liquid.h>
+#include <lora/phy_decoder.h>
+#include <map>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <lora/debugger.h>
+#include <volk/volk.h>
+#include <lora/loraphy.h>
+#include <lora/frame.h>
+#include <boost/circular_buffer.hpp>
+#include <atomic>
+#include <deque>
+#include "preamble_detector.h"
+
+#define DECODER_FRAME_POOL_SIZE    64u   ///< Frames that may be in flight to the sinks before the pool falls back to the heap.
+#define DECODER_HISTOGRAM_BINS     64u   ///< Power-of-two buckets of the per-state tick histograms, one per bit of a 64-bit count.
+#define DECODER_MIN_SYMBOL_QUALITY 0.5f  ///< Payload symbols correlating less with the chirp of their bin count as weak.
+#define DECODER_MAX_WEAK_SYMBOLS   4u    ///< Consecutive weak payload symbols after which the frame is dropped, or ends if inferred without header.
+#define DECODER_PACKET_CONTEXTS    4u    ///< Frames that can be demodulated at the same time; more are dropped after their SFD.
+
+namespace gr {
+    namespace lora {
+
+        /**
+         *  \brief  **DecoderState** : Each state the LoRa decoder can be in.
+         */
+        enum class DecoderState {
+            DETECT,
+            SYNC,
+            FIND_SFD,
+            PAUSE,
+            DECODE_HEADER,
+            DECODE_PAYLOAD,
+            STOP,
+            NUM_STATES
+        };
+
+        /**
+         *  \brief  Return the DecoderState as string for debugging purposes.
+         *
+         *  \param  s
+         *          The state to return to string.
+         */
+        inline const char* state_to_string(DecoderState s) {
+            static const char* DecoderStateLUT[] = { "DETECT", "SYNC", "FIND_SFD", "PAUSE", "DECODE_HEADER", "DECODE_PAYLOAD", "STOP" };
+            return DecoderStateLUT[ (size_t)s ];
+        }
+
+        /**
+         *  \brief  Time spent in one `DecoderState`, in ticks of `phy_decoder_impl::ticks` (TSC cycles on x86).
+         *          <br/>Only `step` writes; readers on other threads may see a step's tick count before its visit.
+         */
+        typedef struct state_counters {
+            std::atomic<uint64_t> ticks;                            ///< Total ticks of all steps in this state.
+            std::atomic<uint64_t> visits;                           ///< Number of steps in this state.
+            std::atomic<uint64_t> histogram[DECODER_HISTOGRAM_BINS];///< Steps per tick count, bucket `i` holding `[2^i, 2^(i+1))`.
+        } state_counters_t;
+
+        /**
+         *  \brief  Everything the receive chain keeps about one frame: the preamble the detector is acquiring,
+         *          or a frame one of the packet contexts is demodulating. Each has its own position in the input,
+         *          so that frames overlapping in time are decoded side by side.
+         */
+        typedef struct packet_context {
+            DecoderState     state;                     ///< State of this context; a free packet context is in `DecoderState::DETECT`.
+            uint64_t         position;                  ///< Absolute index of the next input sample of this context.
+            bool             implicit;                  ///< Implicit header mode of the frame.
+            bool             reduced_rate;              ///< Low data rate optimization of the frame.
+            bool             infer_header;              ///< Decode the frame without header if its checksum fails.
+            bool             infer_reduced_rate;        ///< Set `reduced_rate` from the first payload block of the frame.
+            std::vector<uint8_t> header_block;          ///< Codewords of the header block, kept until its checksum is known.
+            loraphy_header_t phdr;                      ///< LoRa PHY header.
+            uint16_t         mac_crc;                   ///< The MAC CRC.
+            crc_status       crc;                       ///< Outcome of `check_crc`.
+            uint8_t          sync_word;                 ///< Sync word of the frame.
+            bool             inverted;                  ///< The frame has inverted IQ.
+             int32_t         payload_symbols;           ///< The number of symbols needed to decode the payload. Calculated from an indicator in the HDR.
+            uint32_t         payload_length;            ///< The number of words after decoding the HDR or payload. Calculated from an indicator in the HDR.
+            float            symbol_quality;            ///< Correlation of the last demodulated symbol with the ideal chirp of its bin.
+            uint32_t         weak_symbols;              ///< Consecutive payload symbols that failed the energy or quality check.
+            size_t           weak_start;                ///< Size of `demodulated` before the first of the `weak_symbols`.
+            float            energy_threshold;          ///< The absolute threshold to distinguish signal from noise.
+            float            snr;                       ///< Signal to noise ratio, NaN if there was no noise reference at detection.
+            float            cfo_estimation;            ///< An estimation for the Center Frequency Offset of the frame.
+            int32_t          fine_sync;                 ///< Amount of drift correction to apply for next symbol
+            frame_timing_t   timing;                    ///< Timestamps of the frame.
+
+            std::vector<uint32_t> words;                ///< Vector containing the demodulated words.
+            std::vector<uint8_t>  demodulated;          ///< Vector containing the words after deinterleaving.
+            std::vector<uint8_t>  words_deshuffled;     ///< Vector containing the words after deshuffling.
+            std::vector<uint8_t>  words_dewhitened;     ///< Vector containing the words after dewhitening.
+            std::vector<uint8_t>  decoded;              ///< Vector containing the words after Hamming decode or the final decoded words.
+        } packet_context_t;
+
+        /**
+         *  \brief  **LoRa Decoder**
+         *          <br/>The main class for the LoRa decoder.
+         *          Contains all variables and methods necessary for succesfully decoding LoRa PHY.
+         *          <br/>Only the sample rate and spreading factor are needed.
+         *          The other settings, like packet length and coding rate, are extracted from the (explicit) HDR.
+         *          <br/>Runs on plain sample buffers; `decoder_impl` wraps it in a GNU Radio block.
+         */
+        class phy_decoder_impl : public phy_decoder {
+            private:
+                friend class decoder_bench;                 ///< Kernel benchmark in `bench_lora.cc`.
+                friend class multi_sf_decoder_impl;         ///< Runs the decoders of several SFs over one buffer.
+
+                debugger                d_dbg;              ///< Debugger for plotting samples, printing output, etc.
+                packet_context_t        d_acquisition;      ///< Preamble detection and synchronization, which never stops.
+                std::vector<packet_context_t> d_packets;    ///< Frames handed over by `DecoderState::PAUSE`, demodulated in parallel.
+                packet_context_t*       d_ctx;              ///< The context of the running step, which the kernels work on.
+
+                std::vector<gr_complex> d_downchirp;        ///< The complex ideal downchirp.
+                std::vector<float>      d_downchirp_ifreq;  ///< The instantaneous frequency of the ideal downchirp.
+                std::vector<float>      d_downchirp_ifreq_centered; ///< `d_downchirp_ifreq` minus its mean, over the FIND_SFD window.
+                float                   d_downchirp_ifreq_energy;   ///< Sum of squares of `d_downchirp_ifreq_centered`.
+
+                std::vector<gr_complex> d_upchirp;          ///< The complex ideal upchirp.
+                std::vector<float>      d_upchirp_ifreq;    ///< The instantaneous frequency of the ideal upchirp.
+                std::vector<float>      d_upchirp_ifreq_v;  ///< The instantaneous frequency of the ideal upchirp.
+                std::vector<float>      d_upchirp_ifreq_v_centered; ///< `d_upchirp_ifreq_v` minus the mean of one period.
+                float                   d_upchirp_ifreq_energy;     ///< Sum of squares of one period of `d_upchirp_ifreq_v_centered`.
+
+                std::vector<gr_complex> d_fft;              ///< Vector containing the FFT resuls.
+                std::vector<gr_complex> d_mult_hf;          ///< Vector containing the FFT decimation.
+                std::vector<gr_complex> d_tmp;              ///< Vector containing the FFT decimation.
+
+                bool             d_config_implicit;         ///< Implicit header mode as configured.
+                bool             d_config_reduced_rate;     ///< Low data rate optimization as configured.
+                loraphy_header_t d_config_phdr;             ///< CR and MAC CRC as configured, for frames without explicit header.
+                std::atomic<bool> d_autodetect;             ///< Infer the header mode and low data rate optimization of every frame.
+                uint8_t          d_sf;                      ///< The Spreading Factor.
+                uint32_t         d_bw;                      ///< The receiver bandwidth (fixed to `125kHz`).
+                std::atomic<bool> d_drop_invalid;           ///< Drop frames whose MAC CRC does not match.
+                std::atomic<uint64_t> d_sync_word_filter[4];    ///< Bitmap of the accepted sync words, all set to accept any.
+                uint32_t         d_sync_bins[2];            ///< Bins of the last two symbols before the SFD, oldest first.
+                std::atomic<bool> d_dual_polarity;          ///< Also look for preambles with inverted IQ in `DecoderState::SYNC`.
+                double           d_bits_per_second;         ///< Indicator of how many bits are transferred each second.
+                uint32_t         d_delay_after_sync;        ///< The number of samples to skip in `DecoderState::PAUSE`.
+                uint32_t         d_samples_per_second;      ///< The number of samples taken per second by GNU Radio.
+                double           d_symbols_per_second;      ///< Indicator of how many symbols (read: chirps) are transferred each second.
+                double           d_bits_per_symbol;         ///< The number of bits each of the symbols contain.
+                uint32_t         d_samples_per_symbol;      ///< The number of samples in one symbol.
+                double           d_period;                  ///< Period of the symbol.
+                uint32_t         d_number_of_bins;          ///< Indicates in how many parts or bins a symbol is decimated, i.e. the max value to decode out of one payload symbol.
+                uint32_t         d_number_of_bins_hdr;      ///< Indicates in how many parts or bins a HDR symbol is decimated, i.e. the max value to decode out of one HDR symbol.
+                uint32_t         d_corr_fails;              ///< Indicates how many times the correlation failed. After some tries, the state will revert to `DecoderState::DETECT`.
+                boost::circular_buffer<float> d_pwr_queue;  ///< Queue holding symbol power values
+                float            d_noise_power;             ///< Noise reference of the SNR, negative until known. Only updated while no frame is demodulated.
+                uint64_t         d_frame_end;               ///< End of the last symbol a packet context demodulated.
+                bool             d_shared_detection;        ///< Preambles come from a `preamble_detector` shared with other SFs.
+                std::deque<preamble_hit_t> d_shared_hits;   ///< Preambles reported by the shared detector that `DecoderState::DETECT` did not reach yet.
+                uint64_t         d_shared_frontier;         ///< Every preamble starting before this position was reported.
+                uint64_t         d_time_ref_sample;         ///< Input position of `d_time_ref_ns`.
+                uint64_t         d_time_ref_ns;             ///< When the radio received `d_time_ref_sample`, or 0 if unknown.
+
+
+                std::ofstream d_debug_samples;              ///< Debug utputstream for complex values.
+
+                state_counters_t      d_state_counters[(size_t)DecoderState::NUM_STATES];
+
+                uint64_t              d_position;           ///< Samples consumed since construction or `reset`: the position of the context furthest behind.
+                std::vector<gr_complex> d_carry;            ///< Samples kept by `process` for the next block.
+                bool                  d_estimate_cfo;       ///< Estimate the CFO of each frame in `DecoderState::SYNC`.
+
+                std::atomic<uint64_t> d_samples_consumed;   ///< Input samples consumed since the last counter reset.
+                uint64_t              d_counters_origin;    ///< `d_position` at the last counter reset.
+                std::atomic<uint64_t> d_detections;         ///< Preambles detected in `DecoderState::DETECT`.
+                std::atomic<uint64_t> d_sfd_searches;       ///< Transitions from `DecoderState::SYNC` to `DecoderState::FIND_SFD`.
+                std::atomic<uint64_t> d_sync_aborts;        ///< Returns to `DecoderState::DETECT` after too many `d_corr_fails`.
+                std::atomic<uint64_t> d_headers;            ///< Explicit headers decoded.
+                std::atomic<uint64_t> d_sync_word_aborts;   ///< Returns to `DecoderState::DETECT` on a sync word outside `d_sync_word_filter`.
+                std::atomic<uint64_t> d_header_aborts;      ///< Returns to `DecoderState::DETECT` on a header checksum mismatch.
+                std::atomic<uint64_t> d_inferred_implicit;  ///< Frames decoded without header because their header did not check out, with `d_autodetect`.
+                std::atomic<uint64_t> d_payloads;           ///< Payloads decoded and published.
+                std::atomic<uint64_t> d_crc_errors;         ///< Payloads whose MAC CRC did not match.
+                std::atomic<uint64_t> d_payload_aborts;     ///< Returns to `DecoderState::DETECT` after `DECODER_MAX_WEAK_SYMBOLS` weak payload symbols.
+                std::atomic<uint64_t> d_context_aborts;     ///< Frames dropped after their SFD because every packet context was busy.
+                std::atomic<bool>     d_reset_counters;     ///< Set by `reset_counters`, acted upon by the next `step`.
+
+                fftplan d_q;                                ///< The LiquidDSP::FFT_Plan.
+                fftplan d_qr;                               ///< The LiquidDSP::FFT_Plan in reverse.
+                fec     d_h48_fec;                          ///< LiquidDSP Hamming 4/8 FEC.
+                frame_pool::sptr d_frame_pool;              ///< Preallocated output frames.
+
+                uint32_t      d_decim_factor;               ///< The number of samples (data points) in each bin.
+                double        d_dt;                         ///< Indicates how fast the frequency changes in a symbol (chirp).
+                bool    d_enable_fine_sync;                 ///< Enable drift correction
+
+                /**
+                 *  \brief  TODO
+                 */
+                float cross_correlate_ifreq_fast(const float *samples_ifreq, const float *ideal_chirp, const uint32_t window);
+
+                /**
+                 *  \brief  TODO
+                 */
+                float cross_correlate_fast(const gr_complex* samples, const gr_complex* ideal_chirp, const uint32_t window);
+
+                /**
+                 *  \brief  TODO
+                 */
+                void fine_sync(const gr_complex* in_samples, int32_t bin_idx, int32_t search_space);
+
+                /**
+                 *  \brief  Track the symbol timing from one symbol to the next and set the `fine_sync` of the context to the correction.
+                 *
+                 *  \param  samples_ifreq
+                 *          The instantaneous frequency of the symbol.
+                 *  \param  bin_idx
+                 *          The demodulated bin of the symbol.
+                 *  \param  search_space
+                 *          The largest correction, exclusive, in samples.
+                 */
+                void track_timing(const float *samples_ifreq, int32_t bin_idx, int32_t search_space);
+
+                /**
+                 * \brief Schmidl-Cox autocorrelation approach for approximately detecting the preamble.
+                 */
+                float detect_preamble_autocorr(const gr_complex *samples, uint32_t window);
+
+                /**
+                 *  \brief  TODO
+                 */
+                float experimental_determine_cfo(const gr_complex *samples, uint32_t window);
+
+                /**
+                 *  \brief  Generate the ideal up- and downchirps.
+                 */
+                void build_ideal_chirps(void);
+
+                /**
+                 *  \brief  Debug method to dump the given complex array to the given file in binary format.
+                 *
+                 *  \param  path
+                 *          The path to the file to dump to.
+                 *  \param  v
+                 *          The complex array to dump.
+                 *  \param  length
+                 *          Length of said array.
+                 *  \param  elem_size
+                 *          `sizeof` the data in the array.
+                 */
+                void samples_to_file(const std::string path, const gr_complex *v, const uint32_t length, const uint32_t elem_size);
+
+                /**
+                 *  \brief  Write the given complex array to the debug outputstream.
+                 *
+                 *  \param  v
+                 *          The complex array.
+                 *  \param  length
+                 *          Length of said complex array.
+                 */
+                void samples_debug(const gr_complex *v, const uint32_t length);
+
+                /**
+                 *  \brief  Correct the shift of the given symbol to match the ideal upchirp by sliding cross correlating.
+                 *
+                 *  \param  samples_ifreq
+                 *          The symbol to shift.
+                 *  \param  window
+                 *          The window in which the symbol can be shifted (length of given sample array).
+                 *  \param  index
+                 *          The new start index in the window for the found upchirp.
+                 *  \return Also return the correlation coefficient.
+                 */
+                float sliding_norm_cross_correlate_upchirp(const float *samples_ifreq, const uint32_t window, int32_t *index);
+
+                /**
+                 *  \brief Base method to start downchirp correlation and return the correlation coefficient.
+                 *
+                 *  \param  samples
+                 *          The complex array of samples to detect a downchirp in.
+                 *  \param  window
+                 *          Length of said sample.
+                 */
+                float detect_downchirp(const gr_complex *samples, const uint32_t window);
+
+                /**
+                 *  \brief  Downchirp correlation of an already computed instantaneous frequency.
+                 *
+                 *  \param  samples_ifreq
+                 *          The instantaneous frequency of the samples to detect a downchirp in.
+                 *  \param  window
+                 *          Length of said sample.
+                 */
+                float detect_downchirp(const float *samples_ifreq, const uint32_t window);
+
+                /**
+                 *  \brief  Rebuild the sync word from the bins of the two symbols before the SFD. Each one carries
+                 *          a nibble as a shift of 8 chips.
+                 */
+                uint8_t sync_word_from_bins(void) const;
+
+                /**
+                 *  \brief  Whether frames with the given sync word pass `set_sync_words`.
+                 */
+                bool sync_word_accepted(const uint8_t sync_word) const;
+
+                /**
+                 *  \brief  Base method to start upchirp detection by calling `sliding_norm_cross_correlate_upchirp`.
+                 *          <br/>Sets up the instantaneous frequency of the given complex symbol. With dual polarity,
+                 *          also correlates its negation and sets `inverted` to the polarity that matched best.
+                 *
+                 *  \param  samples
+                 *          The complex array of samples to detect an upchirp in.
+                 *  \param  window
+                 *          Length of said sample.
+                 *  \param  index
+                 *          The index to shift with so the upchirp is correctly synced inside its window.
+                 *  \return Also return the correlation coefficient.
+                 */
+                float detect_upchirp(const gr_complex *samples, const uint32_t window, int32_t *index);
+
+                /**
+                 *  \brief  Returns the correlation coefficient when correlating the given complex symbols in the given window.
+                 *
+                 *  \param  samples_1
+                 *          The first complex symbol to correlate with.
+                 *  \param  samples_2
+                 *          The second complex symbol to correlate with.
+                 *  \param  window
+                 *          The window in which to perform correlation.
+                 */
+                float cross_correlate(const gr_complex *samples_1, const gr_complex *samples_2, const uint32_t window);
+
+                /**
+                 *  \brief  Returns the correlation coefficient of a real signal.
+                 *          See https://en.wikipedia.org/wiki/Cross-correlation#Normalized_cross-correlation.
+                 *
+                 *  \param  samples_ifreq
+                 *          The instantaneous frequency of the symbol to correlate with.
+                 *  \param  ideal_chirp
+                 *          The vector containing the ideal chirp to correlate with.
+                 *  \param  to_idx
+                 *          Correlation end index.
+                 */
+                float cross_correlate_ifreq(const float *samples_ifreq, const std::vector<float>& ideal_chirp, const uint32_t to_idx);
+
+                /**
+                 *  \brief  Returns the correlation coefficient of a real signal with a reference of zero mean.
+                 *
+                 *  \param  samples_ifreq
+                 *          The instantaneous frequency of the symbol to correlate with.
+                 *  \param  ideal_centered
+                 *          The ideal chirp minus its mean.
+                 *  \param  ideal_energy
+                 *          The sum of squares of `ideal_centered`.
+                 *  \param  window
+                 *          The number of samples to correlate.
+                 */
+                float cross_correlate_ifreq_centered(const float *samples_ifreq, const float *ideal_centered, const float ideal_energy, const uint32_t window);
+
+                /**
+                 *  \brief  Returns the index of the bin containing the frequency change by using FFT.
+                 *
+                 *  \param  samples
+                 *          The complex symbol to analyse.
+                 */
+                uint32_t get_shift_fft(const gr_complex *samples);
+
+                /**
+                 *  \brief  Determine the center frequency offset in the given symbol.
+                 *
+                 *  \param  samples
+                 *          The complex symbol to analyse.
+                 */
+                void determine_cfo(const gr_complex *samples);
+
+                /**
+                 *  \brief  Determine the energy of a symbol.
+                 *
+                 *  \param  samples
+                 *          The complex symbol to analyse.
+                 */
+                float determine_energy(const gr_complex *samples);
+
+                /**
+                 *  \brief  Determine the SNR of the preamble at the end of `d_pwr_queue`, against `d_noise_power`.
+                 *          NaN while the noise power is not known.
+                 */
+                void determine_snr();
+
+                /**
+                 *  \brief  Returns the index of the bin containing the frequency change.
+                 *
+                 *  \param  samples
+                 *          The complex symbol to analyze.
+                 */
+                uint32_t max_frequency_gradient_idx(const gr_complex *samples);
+
+                /**
+                 *  \brief  Returns the index of the bin containing the frequency change.
+                 *
+                 *  \param  samples_ifreq
+                 *          The instantaneous frequency of the symbol to analyze.
+                 */
+                uint32_t max_frequency_gradient_idx(const float *samples_ifreq);
+
+                /**
+                 *  \brief  Demodulate the given symbol and return true if all expected symbols have been parsed.
+                 *
+                 *  \param  samples
+                 *          The complex symbol to demodulate.
+                 *  \param  is_header
+                 *          Whether the demodulated words were from the HDR.
+                 */
+                bool demodulate(const gr_complex *samples, const bool reduced_rate);
+
+                /**
+                 *  \brief  Whether the bins of a complete payload block in `words` look like the low data rate
+                 *          optimization, which only uses every fourth bin.
+                 */
+                bool looks_reduced_rate(void) const;
+
+                /**
+                 *  \brief  The number of payload symbols of an explicit header frame, from its header and
+                 *          whether it uses the low data rate optimization.
+                 */
+                int32_t payload_symbols(void) const;
+
+                /**
+                 *  \brief  Deinterleave the raw demodulated words by reversing the interleave pattern.
+                 *
+                 *  \param  ppm
+                 *          The number of words that zere interleaved. Depends on `SF`.
+                 */
+                void deinterleave(const uint32_t ppm);
+
+                /**
+                 *  \brief  The process of decoding the demodulated words to get the actual payload.
+                 *          <br/>1. Deshuffle the words
+                 *          <br/>2. Dewhiten the words
+                 *          <br/>3. Hamming decoding
+                 *
+                 *  \param  is_header
+                 *          Whether the demodulated words were from the HDR.
+                 */
+                void decode(const bool is_header);
+
+                /**
+                 *  \brief  Deshuffle the demodulated words by the given pattern.
+                 *
+                 *  \param  shuffle_pattern
+                 *          The order in which the bits appear.
+                 *  \param  is_header
+                 *          Whether the demodulated words were from the HDR.
+                 */
+                void deshuffle(const uint8_t *shuffle_pattern, const bool is_header);
+
+                /**
+                 *  \brief  Dewhiten the deshuffled words by XORing with the whitening sequence.
+                 *
+                 *  \param  prng
+                 *          The whitening sequence to XOR with.
+                 *  \param  whitened
+                 *          The number of leading words that were whitened; the others are passed through.
+                 */
+                void dewhiten(const uint8_t *prng, const uint32_t whitened);
+
+                /**
+                 *  \brief  Discard the frame being decoded and return its context to `DecoderState::DETECT`.
+                 */
+                void drop_frame(void);
+
+                /**
+                 *  \brief  Check the MAC CRC at the end of the decoded payload of an explicit header frame.
+                 */
+                crc_status check_crc(void);
+
+                /**
+                 *  \brief  Use Hamming to decode the dewhitened words.
+                 *          <br/>- CR 4 or 3: Hamming(8,4) or Hamming(7,4) with parity correction
+                 *          <br/>- CR 2 or 1: Extract data only (can only find parity errors, not correct them)
+                 *
+                 *  \param  is_header
+                 *          Decoding for the header?
+                 */
+                void hamming_decode(bool is_header);
+
+                /**
+                 *  \brief  Extract only the data in the given bytes.
+                 *
+                 *  \param  is_header
+                 *          Decoding for the header?
+                 */
+                void extract_data_only(bool is_header);
+
+                /**
+                 *  \brief  Hamming(8,4) decoding by calling `hamming_decode_soft_byte` on each byte.
+                 *          <BR>Each byte is decoded in pairs, the first one becoming the LSB nibble
+                 *          <BR>and the second one the MSB nibble (if even; else just zeroes).
+                 *
+                 *  \param  is_header
+                 *          Decoding for the header?
+                 */
+                void hamming_decode_soft(bool is_header);
+
+                /**
+                 *  \brief  Return the standard deviation for the given array.
+                 *          <br/>Used for cross correlating.
+                 *
+                 *  \param  values
+                 *          The array to calculate the standard deviation for.
+                 *  \param  len
+                 *          Length of said array.
+                 *  \param  mean
+                 *          The mean (average) of the values in the array.
+                 */
+                float stddev(const float *values, const uint32_t len, const float mean);
+
+                /**
+                 *  \brief  Calculate the instantaneous phase for the given complex symbol.
+                 *
+                 *  \param  in_samples
+                 *          The complex array to calculate the instantaneous phase for.
+                 *  \param  out_iphase
+                 *          The output `float` array containing the instantaneous phase.
+                 *  \param  window
+                 *          The size of said arrays.
+                 */
+                inline void instantaneous_phase(const gr_complex *in_samples, float *out_iphase, const uint32_t window);
+
+                /**
+                 *  \brief  Calculate the instantaneous frequency for the given complex symbol.
+                 *
+                 *  \param  in_samples
+                 *          The complex array to calculate the instantaneous frequency for.
+                 *  \param  out_ifreq
+                 *          The output `float` array containing the instantaneous frequency.
+                 *  \param  window
+                 *          The size of said arrays.
+                 */
+                void instantaneous_frequency(const gr_complex *in_samples, float *out_ifreq, const uint32_t window);
+
+                /**
+                 *  \brief  Instantaneous frequency of received samples, negated for a frame with inverted IQ so that
+                 *          its chirps match the ideal ones. Same as conjugating the samples first.
+                 */
+                void received_frequency(const gr_complex *in_samples, float *out_ifreq, const uint32_t window);
+
+                /**
+                 *  \brief  Fill a pooled frame with the decoded header and payload, the timing and the channel estimates.
+                 */
+                frame_sptr build_frame(void);
+
+                /**
+                 *  \brief  Run the state machine of a context for one symbol.
+                 *
+                 *  \param  ctx
+                 *          `d_acquisition` or one of `d_packets`.
+                 *  \param  input
+                 *          At least `lookahead()` samples, starting at the position of `ctx`.
+                 *  \param  frames
+                 *          Receives the frame completed by this step, if any.
+                 *  \return The number of samples consumed, which may be zero when only the state changed.
+                 */
+                uint32_t step(packet_context_t& ctx, const gr_complex *input, std::vector<frame_sptr>& frames);
+
+                /**
+                 *  \brief  Hand the frame synchronized by `d_acquisition` over to a free packet context, which starts
+                 *          demodulating at `position`. Drops the frame if every packet context is busy.
+                 */
+                void start_packet(const uint64_t position);
+
+                /**
+                 *  \brief  The context furthest behind in the input: the next one to step. Always stepping it keeps
+                 *          all contexts within a step of each other, so no more than `lookahead()` samples are kept.
+                 */
+                packet_context_t& lagging(void);
+
+                /**
+                 *  \brief  Whether a packet context is demodulating a frame. The input `DecoderState::DETECT` sees
+                 *          meanwhile is not noise, but that frame.
+                 */
+                bool demodulating(void) const;
+
+                /**
+                 *  \brief  Step the lagging context as long as it is before `limit` and has `lookahead()` samples. With
+                 *          shared detection, a context in `DecoderState::DETECT` also stops at the detection frontier.
+                 *
+                 *  \param  samples
+                 *          The input, starting at `d_position`.
+                 *  \param  length
+                 *          The number of samples in `samples`.
+                 *  \param  limit
+                 *          Absolute position at which to stop.
+                 *  \param  frames
+                 *          Receives the frames completed in the meantime.
+                 *  \return The number of samples every context is done with, which `d_position` moved by.
+                 */
+                size_t run(const gr_complex* samples, size_t length, uint64_t limit, std::vector<frame_sptr>& frames);
+
+                /**
+                 *  \brief  Return a monotonic tick count for the hot path counters: the TSC on x86, nanoseconds elsewhere.
+                 */
+                static uint64_t ticks(void);
+
+                /**
+                 *  \brief  Add one step that took `elapsed` ticks in `state` to the counters.
+                 */
+                void count_state(const DecoderState state, const uint64_t elapsed);
+
+                /**
+                 *  \brief  Zero all counters except `d_counters_origin`. Only called from `step` and the constructor.
+                 */
+                void clear_counters(void);
+
+            public:
+                /**
+                 *  \brief  Default constructor.
+                 *
+                 *  \param  samp_rate
+                 *          The sample rate of the input signal given to `process` later.
+                 *  \param  sf
+                 *          The expected spreqding factor.
+                 */
+                phy_decoder_impl(float samp_rate, uint32_t bandwidth, uint8_t sf, bool implicit, uint8_t cr, bool crc, bool reduced_rate, bool disable_drift_correction);
+
+                /**
+                 *  Default destructor.
+                 */
+                ~phy_decoder_impl();
+
+                std::vector<frame_sptr> process(const gr_complex* samples, size_t length);
+                size_t consume(const gr_complex* samples, size_t length, std::vector<frame_sptr>& frames);
+                std::vector<frame_sptr> flush(void);
+                void reset(void);
+
+                uint32_t lookahead(void) const              { return 2u * d_samples_per_symbol; }
+                size_t   pending(void) const                { return d_carry.size(); }
+                uint64_t position(void) const               { return d_position; }
+                uint32_t samples_per_symbol(void) const     { return d_samples_per_symbol; }
+                uint8_t  sf(void) const                     { return d_sf; }
+                void     set_estimate_cfo(const bool estimate) { d_estimate_cfo = estimate; }
+                void     set_drop_invalid(const bool drop)  { d_drop_invalid = drop; }
+                void     set_sync_words(const std::vector<uint8_t>& sync_words);
+                void     set_dual_polarity(const bool dual) { d_dual_polarity = dual; }
+                void     set_autodetect(const bool autodetect)  { d_autodetect = autodetect; }
+
+                /**
+                 *  \brief  Leave preamble detection to a `preamble_detector` shared with the decoders of other SFs.
+                 *          `DecoderState::DETECT` then skips to the preambles passed to `preamble_detected`, and only
+                 *          correlates there, on all samples, to confirm them.
+                 */
+                void     set_shared_detection(const bool shared)    { d_shared_detection = shared; }
+                void     preamble_detected(const preamble_hit_t& hit) { d_shared_hits.push_back(hit); }
+                //! Every preamble starting before `position` was passed to `preamble_detected`. DETECT does not go beyond.
+                void     set_detection_frontier(const uint64_t position) { d_shared_frontier = position; }
+
+                /**
+                 *  \brief  Tell when the radio received input sample `sample`, in wall clock nanoseconds, so that
+                 *          frames record the arrival time of their preamble. Later samples are assumed to follow
+                 *          at the sample rate.
+                 */
+                void     set_time_reference(const uint64_t sample, const uint64_t ns);
+
+                /**
+                 *  \brief  When the radio received input sample `sample`, following the time reference, or 0 if there is none.
+                 */
+                uint64_t arrival_ns(const uint64_t sample) const;
+
+                uint64_t num_symbols(void);
+                uint64_t num_detections(void);
+                uint64_t num_sfd_searches(void);
+                uint64_t num_sync_aborts(void);
+                uint64_t num_headers(void);
+                uint64_t num_sync_word_aborts(void);
+                uint64_t num_header_aborts(void);
+                uint64_t num_inferred_implicit(void);
+                uint64_t num_payloads(void);
+                uint64_t num_crc_errors(void);
+                uint64_t num_payload_aborts(void);
+                uint64_t num_context_aborts(void);
+                std::map<std::string, uint64_t> state_ticks(void);
+                std::map<std::string, uint64_t> state_visits(void);
+                std::vector<uint64_t> state_histogram(const std::string& state);
+                void reset_counters(void);
+
+                /**
+                 *  \brief  Share of all ticks spent in each state, in `DecoderState` order.
+                 */
+                std::vector<float> state_load(void);
+        };
+    } // namespace lora
+} // namespace gr
+
+#endif /* INCLUDED_LORA_PHY_DECODER_IMPL_H */
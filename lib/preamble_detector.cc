@@ -0,0 +1,203 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+    #include "config.h"
+#endif
+
+#include "preamble_detector.h"
+#include <volk/volk.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace gr {
+    namespace lora {
+
+        static inline void increment(std::atomic<uint64_t>& counter) {
+            counter.store(counter.load(std::memory_order_relaxed) + 1u, std::memory_order_relaxed);
+        }
+
+        preamble_detector::preamble_detector(float samp_rate, uint32_t bandwidth, std::vector<uint8_t> sfs)
+            : d_position(0u),
+              d_windows(0u),
+              d_harmonic_rejects(0u) {
+            std::sort(sfs.begin(), sfs.end());
+            sfs.erase(std::unique(sfs.begin(), sfs.end()), sfs.end());
+
+            if (sfs.empty())
+                throw std::invalid_argument("[LoRa Preamble Detector] At least one spreading factor is needed");
+            if (sfs.front() < 6 || sfs.back() > 12)
+                throw std::invalid_argument("[LoRa Preamble Detector] Spreading factor should be between 6 and 12 (inclusive)");
+
+            for (const uint8_t sf : sfs) {
+                lane_t lane;
+                lane.sf                 = sf;
+                // Rounded the same way as `phy_decoder_impl`, so that both agree on symbol boundaries
+                lane.samples_per_symbol = (uint32_t)((uint32_t)samp_rate / ((double)bandwidth / (1u << sf)));
+                lane.stride             = 1u << (sf - sfs.front());
+                lane.taps               = lane.samples_per_symbol / lane.stride;
+                d_lanes.push_back(lane);
+            }
+
+            reset();
+        }
+
+        void preamble_detector::reset(void) {
+            d_carry.clear();
+            d_position = 0u;
+
+            for (lane_t& lane : d_lanes) {
+                lane.next   = 0u;
+                lane.energy = -1.0f;
+                lane.tests  = 0u;
+                std::fill(lane.power, lane.power + DETECTOR_NOISE_WINDOWS, 0.0f);
+                lane.recent.clear();
+                lane.hits.clear();
+            }
+        }
+
+        /**
+         *  Windows that start in the kept samples are tested on a copy extended with the start of this block,
+         *  all others straight from the caller's buffer. Only the kept samples are ever copied.
+         */
+        void preamble_detector::process(const gr_complex* samples, size_t length) {
+            const uint64_t origin       = d_position;
+            const uint64_t carry_origin = origin - d_carry.size();
+
+            if (!d_carry.empty())
+                d_carry.insert(d_carry.end(), samples, samples + std::min(length, (size_t)lookahead()));
+
+            // Smallest SF first, so that the hits explaining those of larger SFs are known
+            for (lane_t& lane : d_lanes) {
+                if (!d_carry.empty())
+                    scan(lane, &d_carry[0], carry_origin, d_carry.size(), origin);
+                scan(lane, samples, origin, length, UINT64_MAX);
+            }
+
+            d_position = origin + length;
+
+            uint64_t earliest = d_position;
+            for (lane_t& lane : d_lanes) {
+                earliest = std::min(earliest, lane.next);
+                while (!lane.recent.empty() && lane.recent.front() + 3u * lookahead() < d_position)
+                    lane.recent.pop_front();
+            }
+
+            // A window can only start before this block if the whole block went into the carry
+            if (earliest < origin)
+                d_carry.erase(d_carry.begin(), d_carry.begin() + (earliest - carry_origin));
+            else
+                d_carry.assign(samples + (earliest - origin), samples + length);
+        }
+
+        void preamble_detector::flush(void) {
+            const std::vector<gr_complex> silence(lookahead(), gr_complex(0.0f, 0.0f));
+
+            process(&silence[0], silence.size());
+        }
+
+        void preamble_detector::scan(lane_t& lane, const gr_complex* samples, const uint64_t origin, const size_t length, const uint64_t before) {
+            while (lane.next >= origin && lane.next < before && lane.next + 2u * lane.samples_per_symbol <= origin + length)
+                test(lane, samples + (lane.next - origin));
+        }
+
+        void preamble_detector::test(lane_t& lane, const gr_complex* window) {
+            const gr_complex* first  = window;
+            const gr_complex* second = window + lane.samples_per_symbol;
+            float energy_first  = lane.energy;
+            float energy_second = 0.0f;
+            gr_complex dot_product;
+
+            if (lane.stride == 1u) {
+                float magsq[lane.taps];
+
+                if (energy_first < 0.0f) {
+                    volk_32fc_magnitude_squared_32f(magsq, first, lane.taps);
+                    volk_32f_accumulator_s32f(&energy_first, magsq, lane.taps);
+                }
+
+                volk_32fc_x2_conjugate_dot_prod_32fc(&dot_product, first, second, lane.taps);
+                volk_32fc_magnitude_squared_32f(magsq, second, lane.taps);
+                volk_32f_accumulator_s32f(&energy_second, magsq, lane.taps);
+            } else {
+                float re = 0.0f;
+                float im = 0.0f;
+
+                if (energy_first < 0.0f) {
+                    energy_first = 0.0f;
+                    for (uint32_t i = 0u; i < lane.taps * lane.stride; i += lane.stride)
+                        energy_first += std::norm(first[i]);
+                }
+
+                // Spelled out, as std::complex products check for infinities on every sample
+                for (uint32_t i = 0u; i < lane.taps * lane.stride; i += lane.stride) {
+                    const float ar = first[i].real(),  ai = first[i].imag();
+                    const float br = second[i].real(), bi = second[i].imag();
+
+                    re            += ar * br + ai * bi;
+                    im            += ai * br - ar * bi;
+                    energy_second += br * br + bi * bi;
+                }
+
+                dot_product = gr_complex(re, im);
+            }
+
+            const uint64_t position = lane.next;
+
+            // The power of this window, and of the oldest one still in the ring as the noise reference
+            lane.power[lane.tests % DETECTOR_NOISE_WINDOWS] = energy_first / lane.taps;
+            const float noise_power = lane.power[lane.tests + 1u >= DETECTOR_NOISE_WINDOWS ? (lane.tests + 1u) % DETECTOR_NOISE_WINDOWS : 0u];
+
+            lane.energy = energy_second;
+            lane.next  += lane.samples_per_symbol;
+            lane.tests++;
+            increment(d_windows);
+
+            const float energy = energy_first * energy_second;
+            if (energy <= 0.0f || std::abs(dot_product) < DETECTOR_THRESHOLD * std::sqrt(energy))
+                return;
+
+            if (harmonic(lane, position)) {
+                increment(d_harmonic_rejects);
+                return;
+            }
+
+            lane.recent.push_back(position);
+            lane.hits.push_back({ position, noise_power });
+        }
+
+        bool preamble_detector::harmonic(const lane_t& lane, const uint64_t position) const {
+            const uint64_t span = 2u * lane.samples_per_symbol;
+
+            for (const lane_t& smaller : d_lanes) {
+                if (smaller.sf >= lane.sf)
+                    break;
+
+                for (const uint64_t hit : smaller.recent) {
+                    if (hit + span > position && hit < position + span)
+                        return true;
+                }
+            }
+
+            return false;
+        }
+    } // namespace lora
+} // namespace gr
@@ -0,0 +1,142 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LORA_PREAMBLE_DETECTOR_H
+#define INCLUDED_LORA_PREAMBLE_DETECTOR_H
+
+#include <gnuradio/gr_complex.h>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <stdint.h>
+
+#define DETECTOR_THRESHOLD      0.85f   ///< Correlation of a hit. Below the 0.9 a decoder confirms it with, as fewer samples are taken.
+#define DETECTOR_NOISE_WINDOWS  4u      ///< Windows of power history per SF; the oldest is the noise reference of a hit.
+
+namespace gr {
+    namespace lora {
+
+        /**
+         *  \brief  A preamble found by the `preamble_detector`, handed to the decoder of its SF.
+         */
+        typedef struct preamble_hit {
+            uint64_t position;                          ///< Start of the first of the two correlated symbols.
+            float    noise_power;                       ///< Mean sample power a few symbols earlier, before the preamble.
+        } preamble_hit_t;
+
+        /**
+         *  \brief  Preamble detection for several spreading factors on one channel, in a single pass.
+         *          <br/>A preamble of SF `s` repeats every symbol, so the input correlates with itself one symbol
+         *          later, exactly like `phy_decoder_impl::detect_preamble_autocorr` tests it. Instead of all
+         *          samples, the windows of SF `s` are sampled every `2^(s - s_min)` samples: each test takes as
+         *          many samples as a symbol of the smallest SF, and a test runs once per symbol of its own SF.
+         *          A second window is the first window of the next test, so its energy is only summed once.
+         *          The load of all SFs together stays below twice that of the smallest one alone.
+         */
+        class preamble_detector {
+            private:
+                /**
+                 *  \brief  Detection state of one spreading factor.
+                 */
+                typedef struct lane {
+                    uint8_t  sf;                            ///< Spreading factor.
+                    uint32_t samples_per_symbol;            ///< Lag between the two correlated windows.
+                    uint32_t stride;                        ///< Distance between the samples taken in a window.
+                    uint32_t taps;                          ///< Samples taken per window.
+                    uint64_t next;                          ///< Start of the next window pair to test.
+                    float    energy;                        ///< Energy of the window at `next`, or negative if not known yet.
+                    float    power[DETECTOR_NOISE_WINDOWS]; ///< Mean power of the last first windows, a ring indexed by test.
+                    uint64_t tests;                         ///< Tests since the last `reset`, the write index of `power`.
+                    std::deque<uint64_t>        recent;     ///< Hits that may still explain a hit of a larger SF.
+                    std::vector<preamble_hit_t> hits;       ///< Hits not taken by the decoder yet.
+                } lane_t;
+
+                std::vector<lane_t>     d_lanes;            ///< One per SF, smallest SF first.
+                std::vector<gr_complex> d_carry;            ///< Samples from the earliest untested window on, ending at `d_position`.
+                uint64_t                d_position;         ///< Samples received since construction or `reset`.
+
+                std::atomic<uint64_t>   d_windows;          ///< Window pairs tested.
+                std::atomic<uint64_t>   d_harmonic_rejects; ///< Hits dropped because a smaller SF explains them.
+
+                /**
+                 *  \brief  Test every window pair of `lane` that starts before `before` and lies within `samples`.
+                 *
+                 *  \param  samples
+                 *          The input, starting at absolute position `origin`.
+                 *  \param  length
+                 *          The number of samples in `samples`.
+                 */
+                void scan(lane_t& lane, const gr_complex* samples, const uint64_t origin, const size_t length, const uint64_t before);
+
+                /**
+                 *  \brief  Correlate the window at `lane.next` with the one a symbol later, and record a hit.
+                 */
+                void test(lane_t& lane, const gr_complex* window);
+
+                /**
+                 *  \brief  Whether a hit of a smaller SF lies within the windows of `lane` at `position`. The upchirps
+                 *          of a preamble repeat at every multiple of their symbol length, so a preamble of SF `s`
+                 *          also correlates at the lags of SF `s + 1` and `s + 2`.
+                 */
+                bool harmonic(const lane_t& lane, const uint64_t position) const;
+
+            public:
+                /**
+                 *  \param  samp_rate
+                 *          The sample rate of the input.
+                 *  \param  bandwidth
+                 *          The chirp bandwidth.
+                 *  \param  sfs
+                 *          The spreading factors to detect, each between 6 and 12.
+                 */
+                preamble_detector(float samp_rate, uint32_t bandwidth, std::vector<uint8_t> sfs);
+
+                /**
+                 *  \brief  Test every window pair of every SF that the input received so far covers. Keeps the
+                 *          samples of the windows still incomplete, less than `lookahead()` of them.
+                 */
+                void process(const gr_complex* samples, size_t length);
+
+                /**
+                 *  \brief  Finish the windows that start in the kept samples as if the input went on with silence.
+                 */
+                void flush(void);
+
+                /**
+                 *  \brief  Drop the kept samples and hits, and restart positions at zero.
+                 */
+                void reset(void);
+
+                //! Two symbols of the largest SF.
+                uint32_t lookahead(void) const              { return 2u * d_lanes.back().samples_per_symbol; }
+                size_t   num_lanes(void) const              { return d_lanes.size(); }
+                uint8_t  sf(const size_t lane) const        { return d_lanes[lane].sf; }
+                //! Every hit of this lane starting before this position was found.
+                uint64_t frontier(const size_t lane) const  { return d_lanes[lane].next; }
+                //! Hits of this lane since the last call; the caller clears them once handed over.
+                std::vector<preamble_hit_t>& hits(const size_t lane) { return d_lanes[lane].hits; }
+
+                uint64_t num_windows(void) const            { return d_windows.load(std::memory_order_relaxed); }
+                uint64_t num_harmonic_rejects(void) const   { return d_harmonic_rejects.load(std::memory_order_relaxed); }
+        };
+    } // namespace lora
+} // namespace gr
+
+#endif /* INCLUDED_LORA_PREAMBLE_DETECTOR_H */
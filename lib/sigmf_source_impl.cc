@@ -0,0 +1,262 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+    #include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <volk/volk.h>
+#include <algorithm>
+#include <stdexcept>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "sigmf_source_impl.h"
+
+namespace gr {
+    namespace lora {
+
+        sigmf_source::sptr sigmf_source::make(const std::string& path, const std::string& format, bool repeat) {
+            return gnuradio::get_initial_sptr(new sigmf_source_impl(path, format, repeat));
+        }
+
+        static bool ends_with(const std::string& s, const std::string& suffix) {
+            return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+        }
+
+        /**
+         *  Parse a SigMF complex datatype. Only little-endian formats are supported, as on the hosts we run on.
+         */
+        static bool parse_format(std::string s, sample_format* format, uint32_t* item_size) {
+            if (ends_with(s, "_le"))
+                s.resize(s.size() - 3u);
+
+            if (s == "cf32") {
+                *format    = sample_format::CF32;
+                *item_size = 2u * sizeof(float);
+            } else if (s == "ci16") {
+                *format    = sample_format::CI16;
+                *item_size = 2u * sizeof(int16_t);
+            } else if (s == "ci8") {
+                *format    = sample_format::CI8;
+                *item_size = 2u * sizeof(int8_t);
+            } else {
+                return false;
+            }
+
+            return true;
+        }
+
+        static bool annotation_before(const annotation_t& a, const uint64_t sample) {
+            return a.start < sample;
+        }
+
+        sigmf_source_impl::sigmf_source_impl(const std::string& path, const std::string& format, bool repeat)
+            : gr::sync_block("sigmf_source",
+                             gr::io_signature::make(0, 0, 0),
+                             gr::io_signature::make(1, 1, sizeof(gr_complex))),
+            d_repeat(repeat),
+            d_sample_rate(0.0),
+            d_frequency(0.0),
+            d_data(nullptr),
+            d_size(0u),
+            d_length(0u),
+            d_position(0u),
+            d_next_annotation(0u),
+            d_released(0u),
+            d_seek(-1) {
+            std::string base = path;
+            if (ends_with(base, ".sigmf-meta") || ends_with(base, ".sigmf-data"))
+                base.resize(base.size() - 11u);
+
+            const std::string meta = base + ".sigmf-meta";
+            std::string datatype   = "cf32";
+            std::string data       = path;
+
+            if (access(meta.c_str(), R_OK) == 0) {
+                boost::property_tree::ptree pt;
+                try {
+                    boost::property_tree::read_json(meta, pt);
+                } catch (const boost::property_tree::json_parser_error& e) {
+                    throw std::runtime_error("[LoRa SigMF Source] Cannot parse " + meta + ": " + e.message());
+                }
+
+                datatype      = pt.get<std::string>("global.core:datatype", datatype);
+                d_sample_rate = pt.get<double>("global.core:sample_rate", 0.0);
+                data          = base + ".sigmf-data";
+
+                boost::optional<boost::property_tree::ptree&> captures = pt.get_child_optional("captures");
+                if (captures && !captures->empty())
+                    d_frequency = captures->front().second.get<double>("core:frequency", 0.0);
+
+                boost::optional<boost::property_tree::ptree&> annotations = pt.get_child_optional("annotations");
+                if (annotations) {
+                    for (const boost::property_tree::ptree::value_type& a : *annotations) {
+                        d_annotations.push_back({ a.second.get<uint64_t>("core:sample_start", 0u),
+                                                  a.second.get<uint64_t>("core:sample_count", 0u),
+                                                  a.second.get<std::string>("core:label", "") });
+                    }
+                }
+                std::stable_sort(d_annotations.begin(), d_annotations.end(),
+                                 [](const annotation_t& a, const annotation_t& b) { return a.start < b.start; });
+            }
+
+            if (!format.empty())
+                datatype = format;
+            if (!parse_format(datatype, &d_format, &d_item_size))
+                throw std::invalid_argument("[LoRa SigMF Source] Unsupported sample format " + datatype + ", expected cf32, ci16 or ci8");
+
+            map(data);
+        }
+
+        sigmf_source_impl::~sigmf_source_impl() {
+            if (d_data)
+                munmap((void*)d_data, d_size);
+        }
+
+        /**
+         *  Map the whole file read-only. Pages are faulted in on demand, with read-ahead for sequential access.
+         */
+        void sigmf_source_impl::map(const std::string& path) {
+            const int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                throw std::runtime_error("[LoRa SigMF Source] Cannot open " + path + ": " + strerror(errno));
+
+            struct stat st;
+            if (fstat(fd, &st) < 0) {
+                close(fd);
+                throw std::runtime_error("[LoRa SigMF Source] Cannot stat " + path + ": " + strerror(errno));
+            }
+
+            d_size = st.st_size;
+            if (d_size > 0u) {
+                void* p = mmap(nullptr, d_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p == MAP_FAILED) {
+                    close(fd);
+                    throw std::runtime_error("[LoRa SigMF Source] Cannot map " + path + ": " + strerror(errno));
+                }
+
+                madvise(p, d_size, MADV_SEQUENTIAL);
+                d_data = (const uint8_t*)p;
+            }
+
+            close(fd);  // The mapping keeps the file open
+            d_length = d_size / d_item_size;
+        }
+
+        void sigmf_source_impl::convert(gr_complex* out, const uint64_t position, const int n) {
+            const uint8_t* in = d_data + position * d_item_size;
+
+            switch (d_format) {
+                case sample_format::CF32:
+                    memcpy(out, in, n * sizeof(gr_complex));
+                    break;
+                case sample_format::CI16:
+                    volk_16i_s32f_convert_32f((float*)out, (const int16_t*)in, 32768.0f, 2u * n);
+                    break;
+                case sample_format::CI8:
+                    volk_8i_s32f_convert_32f((float*)out, (const int8_t*)in, 128.0f, 2u * n);
+                    break;
+            }
+        }
+
+        /**
+         *  Drop the pages behind the read position from this process, so that replaying a large file does not
+         *  grow the resident set. They stay in the page cache.
+         */
+        void sigmf_source_impl::release() {
+            static const size_t page_mask = ~((size_t)sysconf(_SC_PAGESIZE) - 1u);
+            const size_t offset = d_position * d_item_size;
+
+            if (offset < d_released) {
+                d_released = offset & page_mask;    // Moved back
+            } else if (offset - d_released >= SIGMF_RELEASE_BYTES) {
+                const size_t end = offset & page_mask;
+                madvise((void*)(d_data + d_released), end - d_released, MADV_DONTNEED);
+                d_released = end;
+            }
+        }
+
+        bool sigmf_source_impl::seek(uint64_t sample) {
+            if (sample >= d_length)
+                return false;
+
+            d_seek = sample;
+            return true;
+        }
+
+        uint64_t sigmf_source_impl::annotation_start(uint32_t index) const {
+            return d_annotations.at(index).start;
+        }
+
+        uint64_t sigmf_source_impl::annotation_length(uint32_t index) const {
+            return d_annotations.at(index).length;
+        }
+
+        std::string sigmf_source_impl::annotation_label(uint32_t index) const {
+            return d_annotations.at(index).label;
+        }
+
+        bool sigmf_source_impl::seek_annotation(uint32_t index) {
+            return index < d_annotations.size() && seek(d_annotations[index].start);
+        }
+
+        int sigmf_source_impl::work(int noutput_items,
+                                    gr_vector_const_void_star& input_items,
+                                    gr_vector_void_star& output_items) {
+            (void) input_items;
+            gr_complex* out = (gr_complex*) output_items[0];
+
+            const int64_t target = d_seek.exchange(-1);
+            if (target >= 0) {
+                d_position        = target;
+                d_next_annotation = std::lower_bound(d_annotations.begin(), d_annotations.end(), d_position, annotation_before) - d_annotations.begin();
+            }
+
+            if (d_position >= d_length) {
+                if (!d_repeat || d_length == 0u)
+                    return WORK_DONE;
+
+                d_position        = 0u;
+                d_next_annotation = 0u;
+            }
+
+            const int n = (int)std::min<uint64_t>(noutput_items, d_length - d_position);
+            convert(out, d_position, n);
+
+            for (; d_next_annotation < d_annotations.size() && d_annotations[d_next_annotation].start < d_position + n; d_next_annotation++) {
+                const annotation_t& a = d_annotations[d_next_annotation];
+                add_item_tag(0, nitems_written(0) + (a.start - d_position), pmt::mp("annotation"), pmt::intern(a.label));
+            }
+
+            d_position += n;
+            release();
+
+            return n;
+        }
+
+    } /* namespace lora */
+} /* namespace gr */
@@ -0,0 +1,86 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 gr-lora rpp0.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_LORA_SIGMF_SOURCE_IMPL_H
+#define INCLUDED_LORA_SIGMF_SOURCE_IMPL_H
+
+#include <lora/sigmf_source.h>
+#include <atomic>
+#include <vector>
+
+#define SIGMF_RELEASE_BYTES (64u << 20)     ///< Mapped bytes behind the read position that are handed back to the kernel at once.
+
+namespace gr {
+    namespace lora {
+
+        enum class sample_format : uint8_t { CF32, CI16, CI8 };
+
+        typedef struct annotation {
+            uint64_t    start;                              ///< `core:sample_start`.
+            uint64_t    length;                             ///< `core:sample_count`, or 0 if absent.
+            std::string label;                              ///< `core:label`, or empty if absent.
+        } annotation_t;
+
+        class sigmf_source_impl : public sigmf_source {
+            private:
+                const bool                d_repeat;
+                sample_format             d_format;
+                uint32_t                  d_item_size;      ///< Bytes per complex sample in the file.
+                double                    d_sample_rate;
+                double                    d_frequency;
+                std::vector<annotation_t> d_annotations;    ///< Sorted by `start`.
+
+                const uint8_t*            d_data;           ///< Read-only mapping of the data file, or `nullptr` if it is empty.
+                size_t                    d_size;           ///< Size of the mapping in bytes.
+                uint64_t                  d_length;         ///< Complete samples in the file.
+
+                uint64_t                  d_position;       ///< Next sample to output.
+                size_t                    d_next_annotation;///< First annotation at or after `d_position`.
+                size_t                    d_released;       ///< Mapped bytes before this offset were handed back to the kernel.
+                std::atomic<int64_t>      d_seek;           ///< Pending seek target, or -1.
+
+                void map(const std::string& path);
+                void convert(gr_complex* out, const uint64_t position, const int n);
+                void release();
+
+            public:
+                sigmf_source_impl(const std::string& path, const std::string& format, bool repeat);
+                ~sigmf_source_impl();
+
+                uint64_t    length() const      { return d_length; }
+                double      sample_rate() const { return d_sample_rate; }
+                double      frequency() const   { return d_frequency; }
+                bool        seek(uint64_t sample);
+
+                uint32_t    num_annotations() const { return d_annotations.size(); }
+                uint64_t    annotation_start(uint32_t index) const;
+                uint64_t    annotation_length(uint32_t index) const;
+                std::string annotation_label(uint32_t index) const;
+                bool        seek_annotation(uint32_t index);
+
+                int work(int noutput_items,
+                         gr_vector_const_void_star& input_items,
+                         gr_vector_void_star& output_items);
+        };
+
+    } // namespace lora
+} // namespace gr
+
+#endif /* INCLUDED_LORA_SIGMF_SOURCE_IMPL_H */
@@ -36,9 +36,10 @@ void bind_debugger(py::module& m)
     py::class_<debugger,
         std::shared_ptr<debugger>>(m, "debugger", D(debugger))
 
-        .def(py::init<>(),D(debugger,debugger,0))
-        .def(py::init<gr::lora::debugger const &>(),           py::arg("arg0"),
-           D(debugger,debugger,1)
+        .def(py::init<uint32_t, uint32_t>(),
+           py::arg("num_snapshots") = DEBUGGER_DEFAULT_SNAPSHOTS,
+           py::arg("max_samples") = DEBUGGER_DEFAULT_MAX_SAMPLES,
+           D(debugger,debugger)
         )
 
 
@@ -70,6 +71,24 @@ void bind_debugger(py::module& m)
             D(debugger,store_samples)
         )
 
+
+        
+        .def("num_sent",&debugger::num_sent,       
+            D(debugger,num_sent)
+        )
+
+
+        
+        .def("num_dropped",&debugger::num_dropped,       
+            D(debugger,num_dropped)
+        )
+
+
+        
+        .def("num_truncated",&debugger::num_truncated,       
+            D(debugger,num_truncated)
+        )
+
         ;
 
 
@@ -33,7 +33,7 @@ void bind_decoder(py::module& m)
     using decoder    = ::gr::lora::decoder;
 
 
-    py::class_<decoder, gr::sync_block, gr::block, gr::basic_block,
+    py::class_<decoder, gr::block, gr::basic_block,
         std::shared_ptr<decoder>>(m, "decoder", D(decoder))
 
         .def(py::init(&decoder::make),
@@ -65,6 +65,117 @@ void bind_decoder(py::module& m)
             D(decoder,set_samp_rate)
         )
 
+
+        .def("num_symbols",&decoder::num_symbols,
+            D(decoder,num_symbols)
+        )
+
+
+        .def("num_detections",&decoder::num_detections,
+            D(decoder,num_detections)
+        )
+
+
+        .def("num_sfd_searches",&decoder::num_sfd_searches,
+            D(decoder,num_sfd_searches)
+        )
+
+
+        .def("num_sync_aborts",&decoder::num_sync_aborts,
+            D(decoder,num_sync_aborts)
+        )
+
+
+        .def("num_sync_word_aborts",&decoder::num_sync_word_aborts,
+            D(decoder,num_sync_word_aborts)
+        )
+
+
+        .def("num_headers",&decoder::num_headers,
+            D(decoder,num_headers)
+        )
+
+
+        .def("num_header_aborts",&decoder::num_header_aborts,
+            D(decoder,num_header_aborts)
+        )
+
+
+        .def("num_inferred_implicit",&decoder::num_inferred_implicit,
+            D(decoder,num_inferred_implicit)
+        )
+
+
+        .def("num_payloads",&decoder::num_payloads,
+            D(decoder,num_payloads)
+        )
+
+
+        .def("num_crc_errors",&decoder::num_crc_errors,
+            D(decoder,num_crc_errors)
+        )
+
+
+        .def("num_payload_aborts",&decoder::num_payload_aborts,
+            D(decoder,num_payload_aborts)
+        )
+
+
+        .def("num_context_aborts",&decoder::num_context_aborts,
+            D(decoder,num_context_aborts)
+        )
+
+
+        .def("state_ticks",&decoder::state_ticks,
+            D(decoder,state_ticks)
+        )
+
+
+        .def("state_visits",&decoder::state_visits,
+            D(decoder,state_visits)
+        )
+
+
+        .def("state_histogram",&decoder::state_histogram,
+            py::arg("state"),
+            D(decoder,state_histogram)
+        )
+
+
+        .def("reset_counters",&decoder::reset_counters,
+            D(decoder,reset_counters)
+        )
+
+
+        .def("set_stats_interval",&decoder::set_stats_interval,
+            py::arg("seconds"),
+            D(decoder,set_stats_interval)
+        )
+
+
+        .def("set_drop_invalid",&decoder::set_drop_invalid,
+            py::arg("drop"),
+            D(decoder,set_drop_invalid)
+        )
+
+
+        .def("set_sync_words",&decoder::set_sync_words,
+            py::arg("sync_words"),
+            D(decoder,set_sync_words)
+        )
+
+
+        .def("set_dual_polarity",&decoder::set_dual_polarity,
+            py::arg("dual"),
+            D(decoder,set_dual_polarity)
+        )
+
+
+        .def("set_autodetect",&decoder::set_autodetect,
+            py::arg("autodetect"),
+            D(decoder,set_autodetect)
+        )
+
         ;
 
 
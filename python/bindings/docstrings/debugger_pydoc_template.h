@@ -19,10 +19,7 @@
  static const char *__doc_gr_lora_debugger = R"doc()doc";
 
 
- static const char *__doc_gr_lora_debugger_debugger_0 = R"doc()doc";
-
-
- static const char *__doc_gr_lora_debugger_debugger_1 = R"doc()doc";
+ static const char *__doc_gr_lora_debugger_debugger = R"doc()doc";
 
 
  static const char *__doc_gr_lora_debugger_attach = R"doc()doc";
@@ -36,4 +33,13 @@
 
  static const char *__doc_gr_lora_debugger_store_samples = R"doc()doc";
 
+
+ static const char *__doc_gr_lora_debugger_num_sent = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_debugger_num_dropped = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_debugger_num_truncated = R"doc()doc";
+
   
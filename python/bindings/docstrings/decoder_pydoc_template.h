@@ -34,3 +34,66 @@
  static const char *__doc_gr_lora_decoder_set_samp_rate = R"doc()doc";
 
   
+
+
+ static const char *__doc_gr_lora_decoder_num_symbols = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_decoder_num_detections = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_decoder_num_sfd_searches = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_decoder_num_sync_aborts = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_decoder_num_sync_word_aborts = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_decoder_num_headers = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_decoder_num_header_aborts = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_decoder_num_inferred_implicit = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_decoder_num_payloads = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_decoder_num_crc_errors = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_decoder_num_payload_aborts = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_decoder_num_context_aborts = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_decoder_state_ticks = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_decoder_state_visits = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_decoder_state_histogram = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_decoder_reset_counters = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_decoder_set_stats_interval = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_decoder_set_drop_invalid = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_decoder_set_sync_words = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_decoder_set_dual_polarity = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_decoder_set_autodetect = R"doc()doc";
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+#include "pydoc_macros.h"
+#define D(...) DOC(gr,lora, __VA_ARGS__ )
+/*
+  This file contains placeholders for docstrings for the Python bindings.
+  Do not edit! These were automatically extracted during the binding process
+  and will be overwritten during the build process
+ */
+
+
+
+
+
+
+
+ static const char *__doc_gr_lora_multi_sf_decoder = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_multi_sf_decoder_make = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_multi_sf_decoder_process = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_multi_sf_decoder_flush = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_multi_sf_decoder_decode = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_multi_sf_decoder_reset = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_multi_sf_decoder_lookahead = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_multi_sf_decoder_sfs = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_multi_sf_decoder_decoder = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_multi_sf_decoder_num_windows = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_multi_sf_decoder_num_harmonic_rejects = R"doc()doc";
+
+
+ 
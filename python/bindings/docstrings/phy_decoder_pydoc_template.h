@@ -0,0 +1,119 @@
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+#include "pydoc_macros.h"
+#define D(...) DOC(gr,lora, __VA_ARGS__ )
+/*
+  This file contains placeholders for docstrings for the Python bindings.
+  Do not edit! These were automatically extracted during the binding process
+  and will be overwritten during the build process
+ */
+
+
+
+
+
+
+
+ static const char *__doc_gr_lora_phy_decoder = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_make = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_process = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_flush = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_decode = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_reset = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_lookahead = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_pending = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_position = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_samples_per_symbol = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_sf = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_set_estimate_cfo = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_set_drop_invalid = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_set_sync_words = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_set_dual_polarity = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_set_autodetect = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_num_symbols = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_num_detections = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_num_sfd_searches = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_num_sync_aborts = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_num_sync_word_aborts = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_num_headers = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_num_header_aborts = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_num_inferred_implicit = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_num_payloads = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_num_crc_errors = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_num_payload_aborts = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_num_context_aborts = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_state_ticks = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_state_visits = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_state_histogram = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_phy_decoder_reset_counters = R"doc()doc";
+
+
+  
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+#include "pydoc_macros.h"
+#define D(...) DOC(gr,lora, __VA_ARGS__ )
+/*
+  This file contains placeholders for docstrings for the Python bindings.
+  Do not edit! These were automatically extracted during the binding process
+  and will be overwritten during the build process
+ */
+
+
+
+
+ static const char *__doc_gr_lora_sigmf_source = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_sigmf_source_sigmf_source_0 = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_sigmf_source_sigmf_source_1 = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_sigmf_source_make = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_sigmf_source_length = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_sigmf_source_sample_rate = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_sigmf_source_frequency = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_sigmf_source_seek = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_sigmf_source_num_annotations = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_sigmf_source_annotation_start = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_sigmf_source_annotation_length = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_sigmf_source_annotation_label = R"doc()doc";
+
+
+ static const char *__doc_gr_lora_sigmf_source_seek_annotation = R"doc()doc";
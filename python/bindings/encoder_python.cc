@@ -0,0 +1,97 @@
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(encoder.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(00000000000000000000000000000000)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <lora/encoder.h>
+// pydoc.h is automatically generated in the build directory
+#include <encoder_pydoc.h>
+
+void bind_encoder(py::module& m)
+{
+
+    using encoder    = ::gr::lora::encoder;
+
+
+    py::class_<encoder,
+        std::shared_ptr<encoder>>(m, "encoder", D(encoder))
+
+        .def(py::init<float,uint32_t,uint8_t,uint8_t,bool,bool,bool,uint16_t,uint8_t>(),
+           py::arg("samp_rate"),
+           py::arg("bandwidth"),
+           py::arg("sf"),
+           py::arg("cr") = 4,
+           py::arg("crc") = true,
+           py::arg("implicit") = false,
+           py::arg("reduced_rate") = false,
+           py::arg("preamble_len") = ENCODER_DEFAULT_PREAMBLE_LEN,
+           py::arg("sync_word") = ENCODER_DEFAULT_SYNC_WORD,
+           D(encoder,encoder)
+        )
+
+
+
+        .def("num_symbols",&encoder::num_symbols,
+            py::arg("length"),
+            D(encoder,num_symbols)
+        )
+
+
+        .def("frame_length",&encoder::frame_length,
+            py::arg("length"),
+            D(encoder,frame_length)
+        )
+
+
+        .def("encode",[](encoder& self, const std::vector<uint8_t>& payload) {
+                std::vector<uint32_t> shifts;
+                self.encode(payload.data(), payload.size(), shifts);
+                return shifts;
+            },
+            py::arg("payload"),
+            D(encoder,encode)
+        )
+
+
+        .def("modulate",[](encoder& self, const std::vector<uint8_t>& payload) {
+                std::vector<gr_complex> samples;
+                self.modulate(payload.data(), payload.size(), samples);
+                return samples;
+            },
+            py::arg("payload"),
+            D(encoder,modulate)
+        )
+
+
+        .def("samples_per_symbol",&encoder::samples_per_symbol,
+            D(encoder,samples_per_symbol)
+        )
+
+        ;
+
+
+
+
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_HEADER_FILE(latency.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(00000000000000000000000000000000)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <lora/latency.h>
+// pydoc.h is automatically generated in the build directory
+#include <latency_pydoc.h>
+
+void bind_latency(py::module& m)
+{
+
+
+    py::enum_<::gr::lora::latency_stage>(m,"latency_stage")
+        .value("SFD", ::gr::lora::latency_stage::SFD)
+        .value("PUBLISH", ::gr::lora::latency_stage::PUBLISH)
+        .value("SOCKET_SINK", ::gr::lora::latency_stage::SOCKET_SINK)
+        .value("FILE_SINK", ::gr::lora::latency_stage::FILE_SINK)
+        .export_values()
+    ;
+
+
+
+
+    m.def("wall_time_ns",&::gr::lora::wall_time_ns,
+        D(wall_time_ns)
+    );
+
+
+    m.def("record_latency",&::gr::lora::record_latency,
+        py::arg("stage"),
+        py::arg("ns"),
+        D(record_latency)
+    );
+
+
+    m.def("latency_histogram",&::gr::lora::latency_histogram,
+        py::arg("stage"),
+        D(latency_histogram)
+    );
+
+
+    m.def("latency_mean",&::gr::lora::latency_mean,
+        py::arg("stage"),
+        D(latency_mean)
+    );
+
+
+    m.def("reset_latency",&::gr::lora::reset_latency,
+        D(reset_latency)
+    );
+
+
+
+
+}
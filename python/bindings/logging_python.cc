@@ -0,0 +1,87 @@
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(logging.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(00000000000000000000000000000000)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <lora/logging.h>
+// pydoc.h is automatically generated in the build directory
+#include <logging_pydoc.h>
+
+void bind_logging(py::module& m)
+{
+
+
+    py::enum_<::gr::lora::log_category>(m,"log_category")
+        .value("SYNC", ::gr::lora::log_category::SYNC)
+        .value("DEMOD", ::gr::lora::log_category::DEMOD)
+        .value("DECODE", ::gr::lora::log_category::DECODE)
+        .value("FRAME", ::gr::lora::log_category::FRAME)
+        .export_values()
+    ;
+
+    py::enum_<::gr::lora::log_level>(m,"log_level")
+        .value("OFF", ::gr::lora::log_level::OFF)
+        .value("ERROR", ::gr::lora::log_level::ERROR)
+        .value("WARN", ::gr::lora::log_level::WARN)
+        .value("INFO", ::gr::lora::log_level::INFO)
+        .value("DEBUG", ::gr::lora::log_level::DEBUG)
+        .value("TRACE", ::gr::lora::log_level::TRACE)
+        .export_values()
+    ;
+
+
+
+
+    m.def("set_log_level",&::gr::lora::set_log_level,
+        py::arg("category"),
+        py::arg("level"),
+        D(set_log_level)
+    );
+
+
+    m.def("get_log_level",&::gr::lora::get_log_level,
+        py::arg("category"),
+        D(get_log_level)
+    );
+
+
+    m.def("set_log_levels",&::gr::lora::set_log_levels,
+        py::arg("spec"),
+        D(set_log_levels)
+    );
+
+
+    m.def("set_log_file",&::gr::lora::set_log_file,
+        py::arg("path"),
+        D(set_log_file)
+    );
+
+
+    m.def("log_dropped",&::gr::lora::log_dropped,
+        D(log_dropped)
+    );
+
+
+
+
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(message_mongodb_sink.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(00000000000000000000000000000000)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <lora/message_mongodb_sink.h>
+// pydoc.h is automatically generated in the build directory
+#include <message_mongodb_sink_pydoc.h>
+
+void bind_message_mongodb_sink(py::module& m)
+{
+
+    using message_mongodb_sink    = ::gr::lora::message_mongodb_sink;
+
+
+    py::class_<message_mongodb_sink, gr::block, gr::basic_block,
+        std::shared_ptr<message_mongodb_sink>>(m, "message_mongodb_sink", D(message_mongodb_sink))
+
+        .def(py::init(&message_mongodb_sink::make),
+           py::arg("ip"),
+           py::arg("port"),
+           py::arg("db"),
+           py::arg("collection"),
+           py::arg("tag"),
+           py::arg("batch_size") = 256,
+           py::arg("flush_ms") = 500,
+           py::arg("max_queued") = 65536,
+           D(message_mongodb_sink,make)
+        )
+        
+
+
+
+        
+        .def("num_inserted",&message_mongodb_sink::num_inserted,       
+            D(message_mongodb_sink,num_inserted)
+        )
+
+
+        
+        .def("num_dropped",&message_mongodb_sink::num_dropped,       
+            D(message_mongodb_sink,num_dropped)
+        )
+
+        ;
+
+
+
+
+}
+
+
+
+
+
+
+
+
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(modulator.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(00000000000000000000000000000000)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <lora/modulator.h>
+// pydoc.h is automatically generated in the build directory
+#include <modulator_pydoc.h>
+
+void bind_modulator(py::module& m)
+{
+
+    using modulator    = ::gr::lora::modulator;
+
+
+    py::class_<modulator, gr::sync_block, gr::block, gr::basic_block,
+        std::shared_ptr<modulator>>(m, "modulator", D(modulator))
+
+        .def(py::init(&modulator::make),
+           py::arg("samp_rate"),
+           py::arg("bandwidth"),
+           py::arg("sf"),
+           py::arg("cr") = 4,
+           py::arg("crc") = true,
+           py::arg("implicit") = false,
+           py::arg("reduced_rate") = false,
+           py::arg("preamble_len") = ENCODER_DEFAULT_PREAMBLE_LEN,
+           py::arg("sync_word") = ENCODER_DEFAULT_SYNC_WORD,
+           py::arg("gap_symbols") = 16,
+           D(modulator,make)
+        )
+
+
+
+        .def("queue_frame",&modulator::queue_frame,
+            py::arg("payload"),
+            D(modulator,queue_frame)
+        )
+
+
+        .def("num_queued",&modulator::num_queued,
+            D(modulator,num_queued)
+        )
+
+
+        .def("num_frames",&modulator::num_frames,
+            D(modulator,num_frames)
+        )
+
+        ;
+
+
+
+
+}
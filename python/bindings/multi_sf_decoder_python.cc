@@ -0,0 +1,138 @@
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_HEADER_FILE(multi_sf_decoder.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(00000000000000000000000000000000)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <lora/multi_sf_decoder.h>
+// pydoc.h is automatically generated in the build directory
+#include <multi_sf_decoder_pydoc.h>
+
+// Defined in phy_decoder_python.cc
+py::list frames_to_list(const std::vector<gr::lora::frame_sptr>& frames);
+
+void bind_multi_sf_decoder(py::module& m)
+{
+
+    using multi_sf_decoder = ::gr::lora::multi_sf_decoder;
+    // Only C-contiguous complex64 arrays are accepted, and read in place; other arrays raise a TypeError
+    // instead of being copied behind the caller's back
+    using samples_array    = py::array_t<gr_complex, py::array::c_style>;
+
+
+    py::class_<multi_sf_decoder,
+        std::shared_ptr<multi_sf_decoder>>(m, "multi_sf_decoder", D(multi_sf_decoder))
+
+        .def(py::init(&multi_sf_decoder::make),
+           py::arg("samp_rate"),
+           py::arg("bandwidth"),
+           py::arg("sfs"),
+           py::arg("implicit") = false,
+           py::arg("cr") = 4,
+           py::arg("crc") = true,
+           py::arg("reduced_rate") = false,
+           py::arg("disable_drift_correction") = false,
+           D(multi_sf_decoder,make)
+        )
+
+
+        .def("process",[](multi_sf_decoder& self, samples_array samples) {
+                const gr_complex* data = samples.data();
+                const size_t length    = samples.size();
+                std::vector<gr::lora::frame_sptr> frames;
+                {
+                    py::gil_scoped_release release;
+                    frames = self.process(data, length);
+                }
+                return frames_to_list(frames);
+            },
+            py::arg("samples").noconvert(),
+            D(multi_sf_decoder,process)
+        )
+
+
+        .def("flush",[](multi_sf_decoder& self) {
+                std::vector<gr::lora::frame_sptr> frames;
+                {
+                    py::gil_scoped_release release;
+                    frames = self.flush();
+                }
+                return frames_to_list(frames);
+            },
+            D(multi_sf_decoder,flush)
+        )
+
+
+        .def("decode",[](multi_sf_decoder& self, samples_array samples) {
+                const gr_complex* data = samples.data();
+                const size_t length    = samples.size();
+                std::vector<gr::lora::frame_sptr> frames;
+                {
+                    py::gil_scoped_release release;
+                    frames = self.process(data, length);
+
+                    const std::vector<gr::lora::frame_sptr> tail = self.flush();
+                    frames.insert(frames.end(), tail.begin(), tail.end());
+                }
+                return frames_to_list(frames);
+            },
+            py::arg("samples").noconvert(),
+            D(multi_sf_decoder,decode)
+        )
+
+
+        .def("reset",&multi_sf_decoder::reset,
+            D(multi_sf_decoder,reset)
+        )
+
+
+        .def("lookahead",&multi_sf_decoder::lookahead,
+            D(multi_sf_decoder,lookahead)
+        )
+
+
+        .def("sfs",&multi_sf_decoder::sfs,
+            D(multi_sf_decoder,sfs)
+        )
+
+
+        .def("decoder",&multi_sf_decoder::decoder,
+            py::arg("sf"),
+            D(multi_sf_decoder,decoder)
+        )
+
+
+        .def("num_windows",&multi_sf_decoder::num_windows,
+            D(multi_sf_decoder,num_windows)
+        )
+
+
+        .def("num_harmonic_rejects",&multi_sf_decoder::num_harmonic_rejects,
+            D(multi_sf_decoder,num_harmonic_rejects)
+        )
+
+        ;
+
+
+
+
+}
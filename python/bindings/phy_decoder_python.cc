@@ -0,0 +1,276 @@
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_HEADER_FILE(phy_decoder.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(00000000000000000000000000000000)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <lora/phy_decoder.h>
+// pydoc.h is automatically generated in the build directory
+#include <phy_decoder_pydoc.h>
+
+/**
+ * Describe decoded frames as dictionaries. Called with the GIL held. Also used by the multi_sf_decoder bindings.
+ */
+py::list frames_to_list(const std::vector<gr::lora::frame_sptr>& frames)
+{
+    py::list result;
+
+    for (const gr::lora::frame_sptr& f : frames) {
+        const loraphy_header_t* phdr = f->phy_header();
+        py::dict d;
+        d["payload"]        = py::bytes((const char*)f->payload(), f->payload_length());
+        d["sf"]             = (int)f->loratap_header()->channel.sf;
+        d["cr"]             = (int)phdr->cr;
+        d["has_mac_crc"]    = (bool)phdr->has_mac_crc;
+        d["sync_word"]      = (int)f->loratap_header()->sync_word;
+        d["crc_valid"]      = f->crc() == gr::lora::crc_status::NONE ? py::object(py::none())
+                                                                     : py::object(py::bool_(f->crc() == gr::lora::crc_status::VALID));
+        d["snr"]            = f->channel().snr;
+        d["cfo"]            = f->channel().cfo;
+        d["inverted_iq"]    = f->channel().inverted_iq;
+        d["detect_sample"]  = f->timing().detect_sample;
+        d["sync_sample"]    = f->timing().sync_sample;
+        d["sfd_sample"]     = f->timing().sfd_sample;
+        d["publish_sample"] = f->timing().publish_sample;
+        d["loratap"]        = py::bytes((const char*)f->data(), f->size());
+        result.append(d);
+    }
+
+    return result;
+}
+
+void bind_phy_decoder(py::module& m)
+{
+
+    using phy_decoder    = ::gr::lora::phy_decoder;
+    // Only C-contiguous complex64 arrays are accepted, and read in place; other arrays raise a TypeError
+    // instead of being copied behind the caller's back
+    using samples_array  = py::array_t<gr_complex, py::array::c_style>;
+
+
+    py::class_<phy_decoder,
+        std::shared_ptr<phy_decoder>>(m, "phy_decoder", D(phy_decoder))
+
+        .def(py::init(&phy_decoder::make),
+           py::arg("samp_rate"),
+           py::arg("bandwidth"),
+           py::arg("sf"),
+           py::arg("implicit") = false,
+           py::arg("cr") = 4,
+           py::arg("crc") = true,
+           py::arg("reduced_rate") = false,
+           py::arg("disable_drift_correction") = false,
+           D(phy_decoder,make)
+        )
+
+
+        .def("process",[](phy_decoder& self, samples_array samples) {
+                const gr_complex* data = samples.data();
+                const size_t length    = samples.size();
+                std::vector<gr::lora::frame_sptr> frames;
+                {
+                    py::gil_scoped_release release;
+                    frames = self.process(data, length);
+                }
+                return frames_to_list(frames);
+            },
+            py::arg("samples").noconvert(),
+            D(phy_decoder,process)
+        )
+
+
+        .def("flush",[](phy_decoder& self) {
+                std::vector<gr::lora::frame_sptr> frames;
+                {
+                    py::gil_scoped_release release;
+                    frames = self.flush();
+                }
+                return frames_to_list(frames);
+            },
+            D(phy_decoder,flush)
+        )
+
+
+        .def("decode",[](phy_decoder& self, samples_array samples) {
+                const gr_complex* data = samples.data();
+                const size_t length    = samples.size();
+                std::vector<gr::lora::frame_sptr> frames;
+                {
+                    py::gil_scoped_release release;
+                    frames = self.process(data, length);
+
+                    const std::vector<gr::lora::frame_sptr> tail = self.flush();
+                    frames.insert(frames.end(), tail.begin(), tail.end());
+                }
+                return frames_to_list(frames);
+            },
+            py::arg("samples").noconvert(),
+            D(phy_decoder,decode)
+        )
+
+
+        .def("reset",&phy_decoder::reset,
+            D(phy_decoder,reset)
+        )
+
+
+        .def("lookahead",&phy_decoder::lookahead,
+            D(phy_decoder,lookahead)
+        )
+
+
+        .def("pending",&phy_decoder::pending,
+            D(phy_decoder,pending)
+        )
+
+
+        .def("position",&phy_decoder::position,
+            D(phy_decoder,position)
+        )
+
+
+        .def("samples_per_symbol",&phy_decoder::samples_per_symbol,
+            D(phy_decoder,samples_per_symbol)
+        )
+
+
+        .def("sf",&phy_decoder::sf,
+            D(phy_decoder,sf)
+        )
+
+
+        .def("set_estimate_cfo",&phy_decoder::set_estimate_cfo,
+            py::arg("estimate"),
+            D(phy_decoder,set_estimate_cfo)
+        )
+
+
+        .def("set_drop_invalid",&phy_decoder::set_drop_invalid,
+            py::arg("drop"),
+            D(phy_decoder,set_drop_invalid)
+        )
+
+
+        .def("set_sync_words",&phy_decoder::set_sync_words,
+            py::arg("sync_words"),
+            D(phy_decoder,set_sync_words)
+        )
+
+
+        .def("set_dual_polarity",&phy_decoder::set_dual_polarity,
+            py::arg("dual"),
+            D(phy_decoder,set_dual_polarity)
+        )
+
+
+        .def("set_autodetect",&phy_decoder::set_autodetect,
+            py::arg("autodetect"),
+            D(phy_decoder,set_autodetect)
+        )
+
+
+        .def("num_symbols",&phy_decoder::num_symbols,
+            D(phy_decoder,num_symbols)
+        )
+
+
+        .def("num_detections",&phy_decoder::num_detections,
+            D(phy_decoder,num_detections)
+        )
+
+
+        .def("num_sfd_searches",&phy_decoder::num_sfd_searches,
+            D(phy_decoder,num_sfd_searches)
+        )
+
+
+        .def("num_sync_aborts",&phy_decoder::num_sync_aborts,
+            D(phy_decoder,num_sync_aborts)
+        )
+
+
+        .def("num_sync_word_aborts",&phy_decoder::num_sync_word_aborts,
+            D(phy_decoder,num_sync_word_aborts)
+        )
+
+
+        .def("num_headers",&phy_decoder::num_headers,
+            D(phy_decoder,num_headers)
+        )
+
+
+        .def("num_header_aborts",&phy_decoder::num_header_aborts,
+            D(phy_decoder,num_header_aborts)
+        )
+
+
+        .def("num_inferred_implicit",&phy_decoder::num_inferred_implicit,
+            D(phy_decoder,num_inferred_implicit)
+        )
+
+
+        .def("num_payloads",&phy_decoder::num_payloads,
+            D(phy_decoder,num_payloads)
+        )
+
+
+        .def("num_crc_errors",&phy_decoder::num_crc_errors,
+            D(phy_decoder,num_crc_errors)
+        )
+
+
+        .def("num_payload_aborts",&phy_decoder::num_payload_aborts,
+            D(phy_decoder,num_payload_aborts)
+        )
+
+
+        .def("num_context_aborts",&phy_decoder::num_context_aborts,
+            D(phy_decoder,num_context_aborts)
+        )
+
+
+        .def("state_ticks",&phy_decoder::state_ticks,
+            D(phy_decoder,state_ticks)
+        )
+
+
+        .def("state_visits",&phy_decoder::state_visits,
+            D(phy_decoder,state_visits)
+        )
+
+
+        .def("state_histogram",&phy_decoder::state_histogram,
+            py::arg("state"),
+            D(phy_decoder,state_histogram)
+        )
+
+
+        .def("reset_counters",&phy_decoder::reset_counters,
+            D(phy_decoder,reset_counters)
+        )
+
+        ;
+
+
+
+
+}
@@ -25,9 +25,19 @@ namespace py = pybind11;
     void bind_controller(py::module& m);
     //void bind_debugger(py::module& m);
     void bind_decoder(py::module& m);
+    void bind_encoder(py::module& m);
+    void bind_latency(py::module& m);
+    void bind_logging(py::module& m);
     void bind_message_file_sink(py::module& m);
     void bind_message_socket_sink(py::module& m);
     void bind_message_socket_source(py::module& m);
+    void bind_modulator(py::module& m);
+    void bind_multi_sf_decoder(py::module& m);
+    void bind_phy_decoder(py::module& m);
+    void bind_sigmf_source(py::module& m);
+#ifdef HAS_MONGODB
+    void bind_message_mongodb_sink(py::module& m);
+#endif
 // ) END BINDING_FUNCTION_PROTOTYPES
 
 
@@ -60,8 +70,18 @@ PYBIND11_MODULE(lora_python, m)
     bind_controller(m);
     //bind_debugger(m);
     bind_decoder(m);
+    bind_encoder(m);
+    bind_latency(m);
+    bind_logging(m);
     bind_message_file_sink(m);
     bind_message_socket_sink(m);
     bind_message_socket_source(m);
+    bind_modulator(m);
+    bind_multi_sf_decoder(m);
+    bind_phy_decoder(m);
+    bind_sigmf_source(m);
+#ifdef HAS_MONGODB
+    bind_message_mongodb_sink(m);
+#endif
     // ) END BINDING_FUNCTION_CALLS
 }
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(sigmf_source.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(00000000000000000000000000000000)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <lora/sigmf_source.h>
+// pydoc.h is automatically generated in the build directory
+#include <sigmf_source_pydoc.h>
+
+void bind_sigmf_source(py::module& m)
+{
+
+    using sigmf_source    = ::gr::lora::sigmf_source;
+
+
+    py::class_<sigmf_source, gr::sync_block, gr::block, gr::basic_block,
+        std::shared_ptr<sigmf_source>>(m, "sigmf_source", D(sigmf_source))
+
+        .def(py::init(&sigmf_source::make),
+           py::arg("path"),
+           py::arg("format") = "",
+           py::arg("repeat") = false,
+           D(sigmf_source,make)
+        )
+
+
+
+        .def("length",&sigmf_source::length,
+            D(sigmf_source,length)
+        )
+
+
+        .def("sample_rate",&sigmf_source::sample_rate,
+            D(sigmf_source,sample_rate)
+        )
+
+
+        .def("frequency",&sigmf_source::frequency,
+            D(sigmf_source,frequency)
+        )
+
+
+        .def("seek",&sigmf_source::seek,
+            py::arg("sample"),
+            D(sigmf_source,seek)
+        )
+
+
+        .def("num_annotations",&sigmf_source::num_annotations,
+            D(sigmf_source,num_annotations)
+        )
+
+
+        .def("annotation_start",&sigmf_source::annotation_start,
+            py::arg("index"),
+            D(sigmf_source,annotation_start)
+        )
+
+
+        .def("annotation_length",&sigmf_source::annotation_length,
+            py::arg("index"),
+            D(sigmf_source,annotation_length)
+        )
+
+
+        .def("annotation_label",&sigmf_source::annotation_label,
+            py::arg("index"),
+            D(sigmf_source,annotation_label)
+        )
+
+
+        .def("seek_annotation",&sigmf_source::seek_annotation,
+            py::arg("index"),
+            D(sigmf_source,seek_annotation)
+        )
+
+        ;
+
+
+
+
+}
@@ -54,6 +54,8 @@ class lora_receiver(gr.hier_block2):
 
         # Messages
         self.message_port_register_hier_out('frames')
+        self.message_port_register_hier_out('frame_refs')
+        self.message_port_register_hier_out('stats')
 
         # Connect blocks
         if self.disable_channelization:
@@ -66,6 +68,8 @@ class lora_receiver(gr.hier_block2):
             self.msg_connect((self.decoder, 'control'), (self.channelizer, 'control'))
 
         self.msg_connect((self.decoder, 'frames'), (self, 'frames'))
+        self.msg_connect((self.decoder, 'frame_refs'), (self, 'frame_refs'))
+        self.msg_connect((self.decoder, 'stats'), (self, 'stats'))
 
     def _connect_conj_block_if_enabled(self, source, dest):
         if self.conj:
@@ -81,6 +85,21 @@ class lora_receiver(gr.hier_block2):
         self.sf = sf
         self.decoder.set_sf(self.sf)
 
+    def set_stats_interval(self, seconds):
+        self.decoder.set_stats_interval(seconds)
+
+    def set_drop_invalid(self, drop):
+        self.decoder.set_drop_invalid(drop)
+
+    def set_sync_words(self, sync_words):
+        self.decoder.set_sync_words(sync_words)
+
+    def set_dual_polarity(self, dual):
+        self.decoder.set_dual_polarity(dual)
+
+    def set_autodetect(self, autodetect):
+        self.decoder.set_autodetect(autodetect)
+
     def get_center_freq(self):
         return self.center_freq
 
@@ -7,15 +7,17 @@
 #
 
 from gnuradio import gr, gr_unittest
-# from gnuradio import blocks
+from gnuradio import blocks
+import pmt
+import time
 try:
-    from lora import decoder
+    from lora import decoder, encoder, modulator, latency_histogram, latency_stage, reset_latency
 except ImportError:
     import os
     import sys
     dirname, filename = os.path.split(os.path.abspath(__file__))
     sys.path.append(os.path.join(dirname, "bindings"))
-    from lora import decoder
+    from lora import decoder, encoder, modulator, latency_histogram, latency_stage, reset_latency
 
 class qa_decoder(gr_unittest.TestCase):
 
@@ -34,6 +36,103 @@ class qa_decoder(gr_unittest.TestCase):
         self.tb.run()
         # check data
 
+    def test_002_counters(self):
+        enc = encoder(1e6, 125000, 7)
+        samples = [0j] * 20000 + enc.modulate(list(b"counters")) + [0j] * 20000
+
+        src = blocks.vector_source_c(samples)
+        dec = decoder(1e6, 125000, 7, False, 4, True, False, False)
+        self.tb.connect(src, dec)
+        self.tb.run()
+
+        self.assertEqual(dec.num_payloads(), 1)
+        self.assertGreaterEqual(dec.num_detections(), 1)
+        self.assertGreaterEqual(dec.num_sfd_searches(), 1)
+        self.assertGreater(dec.num_symbols(), 0)
+        visits = dec.state_visits()
+        self.assertGreater(visits["DECODE_PAYLOAD"], 0)
+        self.assertEqual(sum(dec.state_histogram("DETECT")), visits["DETECT"])
+        self.assertEqual(len(dec.state_histogram("DETECT")), 64)
+        self.assertGreaterEqual(sum(latency_histogram(latency_stage.PUBLISH)), 1)
+
+    def test_003_stats(self):
+        # One frame, then an idle channel that never ends: stats must keep coming without frames
+        mod = modulator(1e6, 125000, 7)
+        mod.queue_frame(list(b"stats"))
+        throttle = blocks.throttle(gr.sizeof_gr_complex, 1e6)
+        dec = decoder(1e6, 125000, 7, False, 4, True, False, False)
+        dec.set_stats_interval(0.05)
+        dbg = blocks.message_debug()
+        self.tb.connect(mod, throttle, dec)
+        self.tb.msg_connect((dec, 'stats'), (dbg, 'store'))
+        self.tb.start()
+
+        deadline = time.time() + 10
+        while dec.num_payloads() < 1 and time.time() < deadline:
+            time.sleep(0.01)
+        received = dbg.num_messages()
+        time.sleep(0.3)
+        self.tb.stop()
+        self.tb.wait()
+
+        self.assertGreater(dbg.num_messages(), received)
+        stats = dbg.get_message(dbg.num_messages() - 1)
+        for key in ("detections", "sync_losses", "sync_word_aborts", "headers", "header_aborts", "inferred_implicit", "payloads", "crc_errors", "payload_aborts", "context_aborts", "symbols", "snr", "cpu", "load", "interval", "backlog"):
+            self.assertTrue(pmt.dict_has_key(stats, pmt.intern(key)))
+
+        def value(key):
+            return pmt.to_uint64(pmt.dict_ref(stats, pmt.intern(key), pmt.PMT_NIL))
+        self.assertEqual(value("payloads"), 1)
+        self.assertEqual(value("headers"), 1)
+        self.assertEqual(value("header_aborts"), 0)
+        self.assertEqual(value("inferred_implicit"), 0)
+        self.assertEqual(value("crc_errors"), 0)
+        self.assertEqual(value("payload_aborts"), 0)
+        self.assertEqual(value("context_aborts"), 0)
+        self.assertEqual(value("sync_word_aborts"), 0)
+        self.assertEqual(value("detections"), dec.num_detections())
+        # Symbols are counted for idle input too, so only up to the last message
+        self.assertGreater(value("symbols"), 0)
+        self.assertLessEqual(value("symbols"), dec.num_symbols())
+
+    def test_004_frames_port(self):
+        enc = encoder(1e6, 125000, 7)
+        samples = [0j] * 20000 + enc.modulate(list(b"frames port")) + [0j] * 20000
+
+        src = blocks.vector_source_c(samples)
+        dec = decoder(1e6, 125000, 7, False, 4, True, False, False)
+        dbg = blocks.message_debug()
+        self.tb.connect(src, dec)
+        self.tb.msg_connect((dec, 'frames'), (dbg, 'store'))
+        self.tb.run()
+
+        # A plain LoRaTap blob, readable without the lora module
+        self.assertEqual(dbg.num_messages(), 1)
+        msg = dbg.get_message(0)
+        self.assertTrue(pmt.is_blob(msg))
+        self.assertIn(b"frames port", bytes(pmt.u8vector_elements(msg)))
+
+    def test_005_arrival_time(self):
+        enc = encoder(1e6, 125000, 7)
+        samples = [0j] * 20000 + enc.modulate(list(b"arrival")) + [0j] * 20000
+
+        # The radio received the first sample ten seconds ago, so the frame waited at least that long
+        now = time.time() - 10
+        rx_time = gr.tag_t()
+        rx_time.offset = 0
+        rx_time.key = pmt.intern("rx_time")
+        rx_time.value = pmt.make_tuple(pmt.from_uint64(int(now)), pmt.from_double(now - int(now)))
+
+        src = blocks.vector_source_c(samples, False, 1, [rx_time])
+        dec = decoder(1e6, 125000, 7, False, 4, True, False, False)
+        self.tb.connect(src, dec)
+        reset_latency()
+        self.tb.run()
+
+        # Bucket i counts latencies of [2^i, 2^(i+1)) microseconds
+        self.assertEqual(dec.num_payloads(), 1)
+        self.assertEqual(sum(latency_histogram(latency_stage.PUBLISH)[23:]), 1)
+
 
 if __name__ == '__main__':
     gr_unittest.run(qa_decoder)
@@ -0,0 +1,82 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2026 gr-lora rpp0.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+import os
+import time
+import unittest
+import pmt
+from gnuradio import gr, gr_unittest
+from gnuradio import blocks
+try:
+    from lora import message_mongodb_sink
+except ImportError:
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from lora import message_mongodb_sink
+
+# Any MongoDB-compatible server will do, e.g. a throwaway `mongod --dbpath /tmp/db`
+MONGODB_IP = os.environ.get("GRLORA_TEST_MONGODB_IP", "127.0.0.1")
+MONGODB_PORT = int(os.environ.get("GRLORA_TEST_MONGODB_PORT", "27017"))
+
+def mongodb_collection():
+    try:
+        from pymongo import MongoClient
+        client = MongoClient(MONGODB_IP, MONGODB_PORT, serverSelectionTimeoutMS=500)
+        client.admin.command("ping")
+    except Exception:
+        return None
+    return client["grlora_qa"]["frames"]
+
+class qa_message_mongodb_sink(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+        self.collection = mongodb_collection()
+
+    def tearDown(self):
+        self.tb = None
+
+    def test_001_batched_insert(self):
+        if self.collection is None:
+            raise unittest.SkipTest("no MongoDB server at %s:%d" % (MONGODB_IP, MONGODB_PORT))
+        self.collection.delete_many({})
+
+        num_frames = 1000
+        sink = message_mongodb_sink(MONGODB_IP, MONGODB_PORT, "grlora_qa", "frames", "qa", 64, 50, num_frames)
+        idle = blocks.message_strobe(pmt.PMT_NIL, 1e9)  # Only there to put the sink in the flowgraph
+        self.tb.msg_connect(idle, "strobe", sink, "in")
+        self.tb.start()
+
+        frame = bytes(range(32))
+        for i in range(num_frames):
+            sink.to_basic_block()._post(pmt.intern("in"), pmt.init_u8vector(len(frame), list(frame)))
+
+        deadline = time.time() + 10
+        while sink.num_inserted() < num_frames and time.time() < deadline:
+            time.sleep(0.05)
+
+        self.tb.stop()
+        self.tb.wait()
+
+        self.assertEqual(sink.num_inserted(), num_frames)
+        self.assertEqual(sink.num_dropped(), 0)
+        self.assertEqual(self.collection.count_documents({"tag": "qa"}), num_frames)
+
+    def test_002_invalid_arguments(self):
+        # Checked by the constructor, so that no server is needed
+        with self.assertRaises(ValueError):
+            message_mongodb_sink(MONGODB_IP, MONGODB_PORT, "grlora_qa", "frames", "qa", 0, 50, 1000)
+        with self.assertRaises(ValueError):
+            message_mongodb_sink(MONGODB_IP, MONGODB_PORT, "grlora_qa", "frames", "qa", 64, 50, -1)
+        with self.assertRaises(ValueError):
+            message_mongodb_sink("[::1", MONGODB_PORT, "grlora_qa", "frames", "qa", 64, 50, 1000)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_message_mongodb_sink)
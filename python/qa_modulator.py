@@ -0,0 +1,74 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2026 gr-lora rpp0.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+from gnuradio import gr, gr_unittest
+from gnuradio import blocks
+import pmt
+try:
+    from lora import modulator, encoder, decoder
+except ImportError:
+    import os
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from lora import modulator, encoder, decoder
+
+class qa_modulator(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def test_instance(self):
+        instance = modulator(1e6, 125000, 7)
+
+    def test_001_frame_matches_encoder(self):
+        payload = list(b"hello lora")
+        enc = encoder(1e6, 125000, 7)
+        expected = enc.modulate(payload)
+
+        mod = modulator(1e6, 125000, 7)
+        mod.queue_frame(payload)
+        head = blocks.head(gr.sizeof_gr_complex, len(expected) + 1000)
+        sink = blocks.vector_sink_c()
+        self.tb.connect(mod, head, sink)
+        self.tb.run()
+
+        self.assertComplexTuplesAlmostEqual(expected, sink.data()[:len(expected)], 5)
+        self.assertEqual(mod.num_frames(), 1)
+        tags = [t for t in sink.tags() if str(t.key) == "payload_len"]
+        self.assertEqual(len(tags), 1)
+        self.assertEqual(tags[0].offset, 0)
+
+    def test_002_round_trip(self):
+        payloads = [b"hello lora", bytes(range(64))]
+        enc = encoder(1e6, 125000, 8)
+        length = sum(enc.frame_length(len(p)) + 16 * enc.samples_per_symbol() for p in payloads) + 20000
+
+        mod = modulator(1e6, 125000, 8)
+        for payload in payloads:
+            mod.queue_frame(list(payload))
+        head = blocks.head(gr.sizeof_gr_complex, length)
+        dec = decoder(1e6, 125000, 8, False, 4, True, False, False)
+        dec.set_drop_invalid(True)
+        dbg = blocks.message_debug()
+        self.tb.connect(mod, head, dec)
+        self.tb.msg_connect((dec, 'frames'), (dbg, 'store'))
+        self.tb.run()
+
+        # Only frames with a valid MAC CRC are published
+        self.assertEqual(dbg.num_messages(), len(payloads))
+        self.assertEqual(dec.num_crc_errors(), 0)
+        for i, payload in enumerate(payloads):
+            self.assertIn(payload, bytes(pmt.u8vector_elements(dbg.get_message(i))))
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_modulator)
@@ -0,0 +1,95 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2026 gr-lora rpp0.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+from gnuradio import gr_unittest
+import numpy
+try:
+    from lora import encoder, multi_sf_decoder, phy_decoder
+except ImportError:
+    import os
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from lora import encoder, multi_sf_decoder, phy_decoder
+
+class qa_multi_sf_decoder(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.sfs = [7, 8, 9]
+        self.messages = [b"frame at sf7", b"frame at sf8", b"frame at sf9"]
+
+        gap = numpy.zeros(20000, dtype=numpy.complex64)
+        parts = [gap]
+        for sf, message in zip(self.sfs, self.messages):
+            enc = encoder(1e6, 125000, sf, 1)
+            parts += [numpy.array(enc.modulate(list(message)), dtype=numpy.complex64), gap]
+        self.samples = numpy.concatenate(parts)
+
+    def test_001_decode(self):
+        dec = multi_sf_decoder(1e6, 125000, [9, 7, 8], cr=1)
+        self.assertEqual(dec.sfs(), self.sfs)
+        frames = dec.decode(self.samples)
+
+        self.assertEqual([f["sf"] for f in frames], self.sfs)
+        for frame, message in zip(frames, self.messages):
+            self.assertEqual(frame["payload"][:len(message)], message)
+            self.assertTrue(frame["crc_valid"])
+
+        # Synchronized on the same samples as a decoder running its own detection
+        for sf, frame in zip(self.sfs, frames):
+            alone = phy_decoder(1e6, 125000, sf, cr=1).decode(self.samples)
+            self.assertEqual([f["sync_sample"] for f in alone], [frame["sync_sample"]])
+            self.assertEqual(dec.decoder(sf).num_payloads(), 1)
+
+    def test_002_blocks(self):
+        dec = multi_sf_decoder(1e6, 125000, self.sfs, cr=1)
+        frames = []
+        for i in range(0, len(self.samples), 3000):
+            frames += dec.process(self.samples[i:i + 3000])
+        frames += dec.flush()
+
+        whole = multi_sf_decoder(1e6, 125000, self.sfs, cr=1).decode(self.samples)
+        self.assertEqual([f["payload"] for f in frames], [f["payload"] for f in whole])
+        self.assertEqual([f["sync_sample"] for f in frames], [f["sync_sample"] for f in whole])
+
+    def test_003_harmonics(self):
+        # The preamble of an SF7 frame also repeats at the symbol length of SF8 and SF9
+        enc = encoder(1e6, 125000, 7, 1)
+        gap = numpy.zeros(20000, dtype=numpy.complex64)
+        samples = numpy.concatenate([gap, numpy.array(enc.modulate(list(b"first frame")), dtype=numpy.complex64), gap])
+
+        dec = multi_sf_decoder(1e6, 125000, self.sfs, cr=1)
+        self.assertEqual([f["sf"] for f in dec.decode(samples)], [7])
+        self.assertGreater(dec.num_harmonic_rejects(), 0)
+        self.assertEqual(dec.decoder(8).num_detections(), 0)
+        self.assertEqual(dec.decoder(9).num_detections(), 0)
+        self.assertIsNone(dec.decoder(10))
+
+    def test_004_idle(self):
+        # Noise only: the detector tests every window, but no decoder is handed a preamble
+        noise = (numpy.random.randn(200000) + 1j * numpy.random.randn(200000)).astype(numpy.complex64)
+
+        dec = multi_sf_decoder(1e6, 125000, self.sfs)
+        self.assertEqual(dec.decode(noise), [])
+        self.assertGreater(dec.num_windows(), 0)
+        for sf in self.sfs:
+            self.assertEqual(dec.decoder(sf).num_detections(), 0)
+
+    def test_005_dtype(self):
+        dec = multi_sf_decoder(1e6, 125000, self.sfs, cr=1)
+        with self.assertRaises(TypeError):
+            dec.process(self.samples.astype(numpy.complex128))
+        with self.assertRaises(TypeError):
+            dec.process(self.samples.real.astype(numpy.float32))
+        with self.assertRaises(TypeError):
+            dec.decode(self.samples[::2])
+        self.assertEqual(dec.num_windows(), 0)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_multi_sf_decoder)
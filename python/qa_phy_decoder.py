@@ -0,0 +1,289 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2026 gr-lora rpp0.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+from gnuradio import gr_unittest
+import numpy
+try:
+    from lora import encoder, phy_decoder
+except ImportError:
+    import os
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from lora import encoder, phy_decoder
+
+class qa_phy_decoder(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.enc = encoder(1e6, 125000, 7)
+        self.messages = [b"first frame", b"second frame"]
+        self.starts = []
+
+        parts = []
+        position = 20000
+        for message in self.messages:
+            frame = numpy.array(self.enc.modulate(list(message)), dtype=numpy.complex64)
+            parts += [numpy.zeros(20000, dtype=numpy.complex64), frame]
+            self.starts.append(position)
+            position += len(frame) + 20000
+        # The last frame ends with the capture
+        self.samples = numpy.concatenate(parts)
+
+    def test_001_decode(self):
+        dec = phy_decoder(1e6, 125000, 7)
+        frames = dec.decode(self.samples)
+
+        self.assertEqual(len(frames), len(self.messages))
+        for frame, message, start in zip(frames, self.messages, self.starts):
+            self.assertEqual(frame["payload"][:len(message)], message)
+            self.assertEqual(frame["sf"], 7)
+            self.assertEqual(frame["cr"], 4)
+            self.assertTrue(frame["has_mac_crc"])
+            self.assertTrue(frame["crc_valid"])
+            # Synchronized to one of the eight preamble upchirps
+            self.assertGreaterEqual(frame["sync_sample"], start)
+            self.assertLess(frame["sync_sample"], start + 8 * dec.samples_per_symbol())
+            self.assertLessEqual(frame["detect_sample"], frame["sync_sample"])
+            self.assertLess(frame["sync_sample"], frame["sfd_sample"])
+        self.assertEqual(dec.num_payloads(), len(self.messages))
+        self.assertEqual(dec.num_header_aborts(), 0)
+        self.assertEqual(dec.num_crc_errors(), 0)
+
+    def test_002_blocks(self):
+        dec = phy_decoder(1e6, 125000, 7)
+        frames = []
+        for i in range(0, len(self.samples), 3000):
+            frames += dec.process(self.samples[i:i + 3000])
+            self.assertLess(dec.pending(), dec.lookahead())
+
+        # Without a flush, the frame at the very end is still waiting for its lookahead
+        self.assertEqual(len(frames), len(self.messages) - 1)
+        frames += dec.flush()
+
+        whole = phy_decoder(1e6, 125000, 7).decode(self.samples)
+        self.assertEqual([f["payload"] for f in frames], [f["payload"] for f in whole])
+        self.assertEqual([f["sync_sample"] for f in frames], [f["sync_sample"] for f in whole])
+
+    def test_003_dtype(self):
+        dec = phy_decoder(1e6, 125000, 7)
+        with self.assertRaises(TypeError):
+            dec.process(self.samples.astype(numpy.complex128))
+        with self.assertRaises(TypeError):
+            dec.process(self.samples.real.astype(numpy.float32))
+        # Every other sample: complex64, but not contiguous
+        with self.assertRaises(TypeError):
+            dec.decode(self.samples[::2])
+        self.assertEqual(dec.num_detections(), 0)
+
+
+    def modulate(self, dec, message, **kwargs):
+        """
+        One frame at the SF of `dec` with CR 4/5, and the offsets of its first sync word chirp, header and
+        payload, for an explicit header. Before the header come the upchirps, two sync word chirps and 2.25
+        downchirps.
+        """
+        enc = encoder(1e6, 125000, dec.sf(), 1, **kwargs)
+        frame = numpy.array(enc.modulate(list(message)), dtype=numpy.complex64)
+        sps = dec.samples_per_symbol()
+
+        header = len(frame) - enc.num_symbols(len(message)) * sps
+        return frame, header - 17 * sps // 4, header, header + 8 * sps
+
+    def padded(self, *parts, gap=20000):
+        """
+        The parts one after the other, each preceded and the last one followed by `gap` zeros.
+        """
+        zeros = numpy.zeros(gap, dtype=numpy.complex64)
+        return numpy.concatenate([zeros] + [p for part in parts for p in (part, zeros)])
+
+
+    def test_004_header_checksum(self):
+        dec = phy_decoder(1e6, 125000, 7, cr=1)
+        sps = dec.samples_per_symbol()
+        frame, sync, header, payload = self.modulate(dec, b"first frame")
+
+        # Replace the header block by copies of the first sync word chirp
+        frame[header:payload] = numpy.tile(frame[sync:sync + sps], 8)
+
+        self.assertEqual(dec.decode(self.padded(frame)), [])
+        self.assertEqual(dec.num_header_aborts(), 1)
+        self.assertEqual(dec.num_headers(), 0)
+
+
+    def test_005_crc(self):
+        dec = phy_decoder(1e6, 125000, 7, cr=1)
+        sps = dec.samples_per_symbol()
+        frame, sync, header, payload = self.modulate(dec, b"first frame")
+
+        # Replace the second payload symbol by the first sync word chirp
+        frame[payload + sps:payload + 2 * sps] = frame[sync:sync + sps]
+        samples = self.padded(frame)
+
+        frames = dec.decode(samples)
+        self.assertEqual(len(frames), 1)
+        self.assertFalse(frames[0]["crc_valid"])
+        self.assertEqual(dec.num_crc_errors(), 1)
+
+        dec = phy_decoder(1e6, 125000, 7, cr=1)
+        dec.set_drop_invalid(True)
+        self.assertEqual(dec.decode(samples), [])
+        self.assertEqual(dec.num_crc_errors(), 1)
+        self.assertEqual(dec.num_payloads(), 1)
+
+
+    def test_006_payload_abort(self):
+        dec = phy_decoder(1e6, 125000, 7, cr=1)
+        sps = dec.samples_per_symbol()
+        frame, sync, header, payload = self.modulate(dec, b"first frame, a bit longer than usual")
+
+        # The transmission stops a few symbols into the payload, and the next frame must still be found
+        frames = dec.decode(self.padded(frame[:payload + 4 * sps], frame, gap=40000))
+        self.assertEqual(len(frames), 1)
+        self.assertEqual(dec.num_headers(), 2)
+        self.assertEqual(dec.num_payload_aborts(), 1)
+        self.assertEqual(dec.num_payloads(), 1)
+
+
+    def test_007_sync_words(self):
+        gap = numpy.zeros(20000, dtype=numpy.complex64)
+        parts = [gap]
+        for sync_word in (0x12, 0x34):
+            enc = encoder(1e6, 125000, 7, sync_word=sync_word)
+            parts += [numpy.array(enc.modulate(list(b"first frame")), dtype=numpy.complex64), gap]
+        samples = numpy.concatenate(parts)
+
+        dec = phy_decoder(1e6, 125000, 7)
+        self.assertEqual([f["sync_word"] for f in dec.decode(samples)], [0x12, 0x34])
+
+        dec = phy_decoder(1e6, 125000, 7)
+        dec.set_sync_words([0x34])
+        frames = dec.decode(samples)
+        self.assertEqual([f["sync_word"] for f in frames], [0x34])
+        self.assertEqual(frames[0]["payload"][:11], b"first frame")
+        self.assertEqual(dec.num_sync_word_aborts(), 1)
+        self.assertEqual(dec.num_headers(), 1)
+
+
+    def test_008_dual_polarity(self):
+        # The same frames as uplinks, then as downlinks, which are sent with inverted IQ
+        gap = numpy.zeros(20000, dtype=numpy.complex64)
+        downlink = numpy.conj(self.samples)
+        samples = numpy.concatenate([self.samples, gap, downlink])
+
+        dec = phy_decoder(1e6, 125000, 7)
+        self.assertEqual([f["inverted_iq"] for f in dec.decode(samples)], [False, False])
+
+        dec = phy_decoder(1e6, 125000, 7)
+        dec.set_dual_polarity(True)
+        frames = dec.decode(samples)
+        self.assertEqual([f["inverted_iq"] for f in frames], [False, False, True, True])
+        for frame, message in zip(frames, self.messages * 2):
+            self.assertEqual(frame["payload"][:len(message)], message)
+
+
+    def test_009_autodetect(self):
+        # An explicit header frame, one without header and one with low data rate optimization
+        dec = phy_decoder(1e6, 125000, 7, cr=1)
+        messages = [b"first frame", b"second frame", b"third frame"]
+        parts = []
+        for message, implicit, reduced_rate in zip(messages, (False, True, False), (False, False, True)):
+            parts.append(self.modulate(dec, message, implicit=implicit, reduced_rate=reduced_rate)[0])
+        samples = self.padded(*parts)
+
+        frames = dec.decode(samples)
+        self.assertEqual(len(frames), 2)
+        self.assertNotEqual(frames[1]["payload"][:len(messages[2])], messages[2])
+
+        dec = phy_decoder(1e6, 125000, 7, cr=1)
+        dec.set_autodetect(True)
+        frames = dec.decode(samples)
+        self.assertEqual(len(frames), len(messages))
+        for frame, message in zip(frames, messages):
+            self.assertEqual(frame["payload"][:len(message)], message)
+        # The frame without header is found by its failing checksum, and not dropped
+        self.assertEqual(dec.num_inferred_implicit(), 1)
+        self.assertEqual(dec.num_header_aborts(), 0)
+        self.assertEqual(dec.num_headers(), 2)
+
+
+    def test_010_overlap(self):
+        dec = phy_decoder(1e6, 125000, 7, cr=1)
+        sps = dec.samples_per_symbol()
+        long_message = b"first frame, " * 8
+        long_frame = self.modulate(dec, long_message)[0]
+        short_frame = self.modulate(dec, b"second frame")[0]
+
+        # A much stronger frame starts during the payload of the first one, and ends well before it. The
+        # symbols it covers are lost, but the first frame is still followed to its end, and reported.
+        samples = self.padded(long_frame)
+        start = 20000 + 40 * sps
+        samples[start:start + len(short_frame)] += 8 * short_frame
+        noise = numpy.random.RandomState(1).randn(2, len(samples)) * 0.02
+        samples += (noise[0] + 1j * noise[1]).astype(numpy.complex64)
+
+        frames = dec.decode(samples)
+        self.assertEqual(len(frames), 2)
+        self.assertEqual(frames[0]["payload"][:12], b"second frame")
+        self.assertTrue(frames[0]["crc_valid"])
+        self.assertEqual(frames[1]["payload"][:13], long_message[:13])
+        self.assertFalse(frames[1]["crc_valid"])
+        self.assertGreater(frames[0]["sync_sample"], frames[1]["sync_sample"])
+        # Both against the noise before the first frame, not the payload the second one started in
+        self.assertAlmostEqual(frames[0]["snr"] - frames[1]["snr"], 18.0, delta=1.0)
+        self.assertEqual(dec.num_headers(), 2)
+        self.assertEqual(dec.num_crc_errors(), 1)
+        self.assertEqual(dec.num_context_aborts(), 0)
+
+        # The next frame starts half a symbol before the first one ends, at the same power: both decode
+        both = numpy.zeros(len(long_frame) + len(short_frame) - sps // 2, dtype=numpy.complex64)
+        both[:len(long_frame)] += long_frame
+        both[-len(short_frame):] += short_frame
+
+        dec = phy_decoder(1e6, 125000, 7, cr=1)
+        frames = dec.decode(self.padded(both))
+        self.assertEqual(len(frames), 2)
+        self.assertEqual(frames[0]["payload"][:len(long_message)], long_message)
+        self.assertTrue(frames[0]["crc_valid"])
+        self.assertEqual(frames[1]["payload"][:12], b"second frame")
+        self.assertTrue(frames[1]["crc_valid"])
+
+
+    def test_011_unshifted_symbol(self):
+        # A data symbol with chirp shift 0 has no frequency wrap, and must still demodulate to the
+        # last bin, 2^SF - 1. CR 4/5 only detects errors, so a wrong bin shows in the CRC.
+        for sf in (7, 8, 9):
+            dec = phy_decoder(1e6, 125000, sf, cr=1)
+            enc = encoder(1e6, 125000, sf, 1)
+            payloads = (bytes((i + 37 * j) % 256 for j in range(8)) for i in range(256))
+            payload = next(p for p in payloads if 0 in enc.encode(list(p))[8:])
+
+            frames = dec.decode(self.padded(self.modulate(dec, payload)[0]))
+            self.assertEqual(len(frames), 1)
+            self.assertEqual(frames[0]["payload"][:len(payload)], payload)
+            self.assertTrue(frames[0]["crc_valid"])
+
+
+    def test_012_invalid_sf(self):
+        for sf in (5, 13):
+            with self.assertRaises(ValueError):
+                phy_decoder(1e6, 125000, sf)
+
+
+    def test_013_snr_reference(self):
+        dec = phy_decoder(1e6, 125000, 7)
+        frame = self.modulate(dec, b"first frame")[0]
+
+        # Nothing before the first frame to measure the noise on, and exact zeros before the second one
+        frames = dec.decode(numpy.concatenate([frame, self.padded(frame)]))
+        self.assertEqual(len(frames), 2)
+        self.assertTrue(numpy.isnan(frames[0]["snr"]))
+        self.assertTrue(numpy.isposinf(frames[1]["snr"]))
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_phy_decoder)
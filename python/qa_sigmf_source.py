@@ -0,0 +1,84 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2026 gr-lora rpp0.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+from gnuradio import gr, gr_unittest
+from gnuradio import blocks
+import json
+import os
+import shutil
+import struct
+import tempfile
+try:
+    from lora import sigmf_source
+except ImportError:
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from lora import sigmf_source
+
+class qa_sigmf_source(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+        self.directory = tempfile.mkdtemp()
+
+    def tearDown(self):
+        self.tb = None
+        shutil.rmtree(self.directory)
+
+    def test_001_ci16_recording(self):
+        values = [(i * 1000) % 32768 - 16384 for i in range(2000)]
+        base = os.path.join(self.directory, "capture")
+        with open(base + ".sigmf-data", "wb") as f:
+            f.write(struct.pack("<%dh" % len(values), *values))
+        with open(base + ".sigmf-meta", "w") as f:
+            json.dump({
+                "global": {"core:datatype": "ci16_le", "core:sample_rate": 1e6, "core:version": "1.0.0"},
+                "captures": [{"core:sample_start": 0, "core:frequency": 868.1e6}],
+                "annotations": [{"core:sample_start": 100, "core:sample_count": 50, "core:label": "frame"}],
+            }, f)
+
+        src = sigmf_source(base + ".sigmf-meta")
+        self.assertEqual(src.length(), 1000)
+        self.assertEqual(src.sample_rate(), 1e6)
+        self.assertEqual(src.frequency(), 868.1e6)
+        self.assertEqual(src.num_annotations(), 1)
+        self.assertEqual(src.annotation_start(0), 100)
+        self.assertEqual(src.annotation_label(0), "frame")
+
+        sink = blocks.vector_sink_c()
+        self.tb.connect(src, sink)
+        self.tb.run()
+
+        expected = [complex(values[2 * i], values[2 * i + 1]) / 32768.0 for i in range(1000)]
+        self.assertComplexTuplesAlmostEqual(expected, sink.data(), 6)
+        tags = [t for t in sink.tags() if str(t.key) == "annotation"]
+        self.assertEqual(len(tags), 1)
+        self.assertEqual(tags[0].offset, 100)
+
+    def test_002_raw_ci8_seek(self):
+        path = os.path.join(self.directory, "raw.ci8")
+        with open(path, "wb") as f:
+            f.write(bytes(range(256)))
+
+        src = sigmf_source(path, "ci8")
+        self.assertEqual(src.length(), 128)
+        self.assertTrue(src.seek(64))
+        self.assertFalse(src.seek(128))
+
+        sink = blocks.vector_sink_c()
+        self.tb.connect(src, sink)
+        self.tb.run()
+
+        signed = [b - 256 if b > 127 else b for b in range(128, 256)]
+        expected = [complex(signed[2 * i], signed[2 * i + 1]) / 128.0 for i in range(64)]
+        self.assertComplexTuplesAlmostEqual(expected, sink.data(), 6)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_sigmf_source)
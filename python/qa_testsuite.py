@@ -224,7 +224,7 @@ class qa_testsuite():
 
                 # Build flowgraph
                 tb = gr.top_block()
-                file_source = blocks.file_source(gr.sizeof_gr_complex, data_file, False)
+                file_source = lora.sigmf_source(data_file)
                 if sf > 10:  # The devices used in the test suites use reduced rate mode for SF > 10 TODO this should be calculated based on symbol time exceeding 16ms per symbol
                     lora_receiver = lora.lora_receiver(sample_rate, capture_freq, [868100000], bw, sf, False, 4, True, reduced_rate=True, decimation=1)
                 else: